@@ -70,6 +70,34 @@ LIST(stats_list);
 
 PROCESS(powertrace_process, "Periodic power output");
 /*---------------------------------------------------------------------------*/
+#if ENERGEST_CONF_ON && ENERGEST_CONF_PROCESSES
+/* Print the CPU time of each process and its share, in hundredths of a
+   percent, of all CPU time. */
+static void
+print_processes(char *str, unsigned long seqno, unsigned long all_cpu)
+{
+  struct process *p;
+  unsigned long cpu, scaled_cpu, scaled_all;
+  int share;
+
+  for(p = PROCESS_LIST(); p != NULL; p = p->next) {
+    cpu = energest_process_time(p);
+    /* keep 10000 * cpu within 32 bits */
+    scaled_cpu = cpu;
+    scaled_all = all_cpu;
+    while(scaled_all > 0x10000UL) {
+      scaled_cpu >>= 1;
+      scaled_all >>= 1;
+    }
+    share = scaled_all == 0 ? 0 : (int)((10000UL * scaled_cpu) / scaled_all);
+    printf("%s %lu PP %d.%d %lu %lu (cpu %d.%02d%%) %s\n",
+           str,
+           clock_time(), rimeaddr_node_addr.u8[0], rimeaddr_node_addr.u8[1],
+           seqno, cpu, share / 100, share % 100, PROCESS_NAME_STRING(p));
+  }
+}
+#endif /* ENERGEST_CONF_ON && ENERGEST_CONF_PROCESSES */
+/*---------------------------------------------------------------------------*/
 void
 powertrace_print(char *str)
 {
@@ -189,6 +217,9 @@ powertrace_print(char *str)
     s->last_output_rxtime = s->output_rxtime;
     
   }
+#if ENERGEST_CONF_ON && ENERGEST_CONF_PROCESSES
+  print_processes(str, seqno, all_cpu);
+#endif /* ENERGEST_CONF_ON && ENERGEST_CONF_PROCESSES */
   seqno++;
 }
 /*---------------------------------------------------------------------------*/
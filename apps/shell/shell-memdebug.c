@@ -40,6 +40,7 @@
  */
 
 #include "contiki.h"
+#include "lib/memb.h"
 #include "shell-memdebug.h"
 
 #include <stdio.h>
@@ -56,6 +57,13 @@ SHELL_COMMAND(peek_command,
 	      "peek",
 	      "peek <address>: read a byte from address <address>",
 	      &shell_peek_process);
+#if MEMB_STATS
+PROCESS(shell_memb_process, "memb");
+SHELL_COMMAND(memb_command,
+	      "memb",
+	      "memb: show memory block usage",
+	      &shell_memb_process);
+#endif /* MEMB_STATS */
 /*---------------------------------------------------------------------------*/
 PROCESS_THREAD(shell_poke_process, ev, data)
 {
@@ -120,10 +128,31 @@ PROCESS_THREAD(shell_peek_process, ev, data)
   PROCESS_END();
 }
 /*---------------------------------------------------------------------------*/
+#if MEMB_STATS
+PROCESS_THREAD(shell_memb_process, ev, data)
+{
+  struct memb *m;
+  char buf[64];
+
+  PROCESS_BEGIN();
+
+  for(m = memb_pools(); m != NULL; m = m->next) {
+    snprintf(buf, sizeof(buf), ": %u/%u used, max %u, %u failed, size %u",
+             m->used, m->num, m->max_used, m->failed, m->size);
+    shell_output_str(&memb_command, (char *)m->name, buf);
+  }
+
+  PROCESS_END();
+}
+#endif /* MEMB_STATS */
+/*---------------------------------------------------------------------------*/
 void
 shell_memdebug_init(void)
 {
   shell_register_command(&poke_command);
   shell_register_command(&peek_command);
+#if MEMB_STATS
+  shell_register_command(&memb_command);
+#endif /* MEMB_STATS */
 }
 /*---------------------------------------------------------------------------*/
@@ -0,0 +1,124 @@
+/*
+ * Copyright (c) 2013, Swedish Institute of Computer Science.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the Institute nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE INSTITUTE AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE INSTITUTE OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ *
+ * This file is part of the Contiki operating system.
+ *
+ */
+
+/**
+ * \file
+ *         Contiki shell command that dumps the process dispatch trace.
+ *
+ *         The output is meant for tools/proctrace/parse-proctrace:
+ *         an "S" line with the rtimer rate and the number of records
+ *         lost to overwriting, an "N" line per running process and
+ *         a "T" line per record, oldest first. The dumped records
+ *         are removed from the trace.
+ */
+
+#include "contiki.h"
+#include "shell-proctrace.h"
+#include "sys/proctrace.h"
+
+#include <stdio.h>
+
+/*---------------------------------------------------------------------------*/
+PROCESS(shell_proctrace_process, "proctrace");
+SHELL_COMMAND(proctrace_command,
+	      "proctrace",
+	      "proctrace: dump and clear the process dispatch trace",
+	      &shell_proctrace_process);
+/*---------------------------------------------------------------------------*/
+#if PROCTRACE_CONF_SIZE
+/* The number of the process in the "N" lines: 0 for broadcasts and -1
+   for processes that have exited since the record was made. */
+static int
+process_number(struct process *p)
+{
+  struct process *q;
+  int n;
+
+  if(p == PROCESS_BROADCAST) {
+    return 0;
+  }
+  n = 1;
+  for(q = PROCESS_LIST(); q != NULL; q = q->next) {
+    if(q == p) {
+      return n;
+    }
+    ++n;
+  }
+  return -1;
+}
+#endif /* PROCTRACE_CONF_SIZE */
+/*---------------------------------------------------------------------------*/
+PROCESS_THREAD(shell_proctrace_process, ev, data)
+{
+#if PROCTRACE_CONF_SIZE
+  struct proctrace_record r;
+  struct process *p;
+  char buf[40];
+  int n;
+#endif /* PROCTRACE_CONF_SIZE */
+  PROCESS_BEGIN();
+
+#if PROCTRACE_CONF_SIZE
+  /* Do not trace ourselves while the buffer is being emptied. */
+  proctrace_enable(0);
+
+  sprintf(buf, "S %lu %u", (unsigned long)RTIMER_SECOND,
+	  proctrace_overwritten);
+  shell_output_str(&proctrace_command, buf, "");
+
+  n = 1;
+  for(p = PROCESS_LIST(); p != NULL; p = p->next) {
+    sprintf(buf, "N %d ", n++);
+    shell_output_str(&proctrace_command, buf, PROCESS_NAME_STRING(p));
+  }
+
+  while(proctrace_read(&r)) {
+    sprintf(buf, "T %u %u %d %u %u", r.time, r.type,
+	    process_number(r.p), r.ev, r.arg);
+    shell_output_str(&proctrace_command, buf, "");
+  }
+
+  proctrace_enable(1);
+#else /* PROCTRACE_CONF_SIZE */
+  shell_output_str(&proctrace_command,
+		   "proctrace: not enabled, set PROCTRACE_CONF_SIZE", "");
+#endif /* PROCTRACE_CONF_SIZE */
+
+  PROCESS_END();
+}
+/*---------------------------------------------------------------------------*/
+void
+shell_proctrace_init(void)
+{
+  shell_register_command(&proctrace_command);
+}
+/*---------------------------------------------------------------------------*/
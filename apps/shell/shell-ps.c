@@ -40,6 +40,7 @@
 
 #include "contiki.h"
 #include "shell-ps.h"
+#include "sys/energest.h"
 
 #include <stdio.h>
 #include <string.h>
@@ -50,6 +51,11 @@ SHELL_COMMAND(ps_command,
 	      "ps",
 	      "ps: list all running processes",
 	      &shell_ps_process);
+PROCESS(shell_cpu_process, "cpu");
+SHELL_COMMAND(cpu_command,
+	      "cpu",
+	      "cpu: list the CPU time used by each process",
+	      &shell_cpu_process);
 /*---------------------------------------------------------------------------*/
 PROCESS_THREAD(shell_ps_process, ev, data)
 {
@@ -66,9 +72,32 @@ PROCESS_THREAD(shell_ps_process, ev, data)
   PROCESS_END();
 }
 /*---------------------------------------------------------------------------*/
+PROCESS_THREAD(shell_cpu_process, ev, data)
+{
+#if ENERGEST_CONF_ON && ENERGEST_CONF_PROCESSES
+  struct process *p;
+  char buf[20];
+#endif /* ENERGEST_CONF_ON && ENERGEST_CONF_PROCESSES */
+  PROCESS_BEGIN();
+
+#if ENERGEST_CONF_ON && ENERGEST_CONF_PROCESSES
+  shell_output_str(&cpu_command, "CPU time (rtimer ticks):", "");
+  for(p = PROCESS_LIST(); p != NULL; p = p->next) {
+    sprintf(buf, "%10lu ", energest_process_time(p));
+    shell_output_str(&cpu_command, buf, PROCESS_NAME_STRING(p));
+  }
+#else /* ENERGEST_CONF_ON && ENERGEST_CONF_PROCESSES */
+  shell_output_str(&cpu_command,
+		   "cpu: not enabled, set ENERGEST_CONF_PROCESSES", "");
+#endif /* ENERGEST_CONF_ON && ENERGEST_CONF_PROCESSES */
+
+  PROCESS_END();
+}
+/*---------------------------------------------------------------------------*/
 void
 shell_ps_init(void)
 {
   shell_register_command(&ps_command);
+  shell_register_command(&cpu_command);
 }
 /*---------------------------------------------------------------------------*/
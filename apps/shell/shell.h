@@ -390,6 +390,7 @@ struct shell_input {
 #include "shell-ping.h"
 #include "shell-power.h"
 #include "shell-powertrace.h"
+#include "shell-proctrace.h"
 #include "shell-ps.h"
 #include "shell-reboot.h"
 #include "shell-rime-debug.h"
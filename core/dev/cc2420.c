@@ -55,6 +55,14 @@
 
 #define WITH_SEND_CCA 1
 
+/* Asynchronous transmissions need the SFD capture interrupt to tell
+   when a frame has been sent (see cc2420-arch-sfd.c). */
+#ifdef CC2420_CONF_SFD_TIMESTAMPS
+#define WITH_ASYNC_TX CC2420_CONF_SFD_TIMESTAMPS
+#else /* CC2420_CONF_SFD_TIMESTAMPS */
+#define WITH_ASYNC_TX 0
+#endif /* CC2420_CONF_SFD_TIMESTAMPS */
+
 #define FOOTER_LEN 2
 
 #ifndef CC2420_CONF_CHECKSUM
@@ -132,6 +140,10 @@ static int cc2420_read(void *buf, unsigned short bufsize);
 
 static int cc2420_prepare(const void *data, unsigned short len);
 static int cc2420_transmit(unsigned short len);
+#if WITH_ASYNC_TX
+static int cc2420_transmit_async(unsigned short len,
+                                 radio_tx_callback_t callback, void *ptr);
+#endif /* WITH_ASYNC_TX */
 static int cc2420_send(const void *data, unsigned short len);
 
 static int cc2420_receiving_packet(void);
@@ -156,6 +168,11 @@ const struct radio_driver cc2420_driver =
     pending_packet,
     cc2420_on,
     cc2420_off,
+#if WITH_ASYNC_TX
+    cc2420_transmit_async,
+#else /* WITH_ASYNC_TX */
+    NULL,
+#endif /* WITH_ASYNC_TX */
   };
 
 static uint8_t receive_on;
@@ -200,6 +217,19 @@ status(void)
 /*---------------------------------------------------------------------------*/
 static uint8_t locked, lock_on, lock_off;
 
+#if WITH_ASYNC_TX
+/* An asynchronous transmission holds the lock from when it starts
+   until finish_tx(). tx_callback is set while the frame is being
+   sent, tx_done from its end until finish_tx(). */
+static radio_tx_callback_t volatile tx_callback;
+static void *tx_ptr;
+static volatile uint8_t tx_done;
+static int tx_txpower;
+#ifdef ENERGEST_CONF_LEVELDEVICE_LEVELS
+static int tx_level;
+#endif
+#endif /* WITH_ASYNC_TX */
+
 static void
 on(void)
 {
@@ -340,8 +370,55 @@ cc2420_init(void)
   return 1;
 }
 /*---------------------------------------------------------------------------*/
+#if WITH_ASYNC_TX
+/*
+ * Clean up after an asynchronous transmission, once its frame has
+ * been sent. This needs the SPI, so it is not done from the
+ * interrupt but from the driver process, or by the next call that
+ * uses the radio, whichever comes first.
+ */
+static void
+finish_tx(void)
+{
+  tx_done = 0;
+  if(!receive_on) {
+    /* We need to explicitly turn off the radio,
+     * since STXON[CCA] -> TX_ACTIVE -> RX_ACTIVE */
+    off();
+  }
+  if(tx_txpower >= 0) {
+    /* Restore the transmission power */
+    set_txpower(tx_txpower & 0xff);
+  }
+  RELEASE_LOCK();
+}
+/*---------------------------------------------------------------------------*/
+/* Wait for an asynchronous transmission to end, and clean up after it. */
+static void
+wait_tx(void)
+{
+  int s;
+
+  BUSYWAIT_UNTIL(tx_callback == NULL, RTIMER_SECOND / 10);
+  if(tx_callback != NULL) {
+    /* The SFD interrupt never came; end the transmission anyway, as
+       cc2420_transmit() does when it times out. */
+    s = splhigh();
+    cc2420_sfd_end_interrupt();
+    splx(s);
+  }
+  if(tx_done) {
+    finish_tx();
+  }
+}
+#endif /* WITH_ASYNC_TX */
+/*---------------------------------------------------------------------------*/
+/*
+ * Send the frame in the TX FIFO. With a callback, return as soon as
+ * the frame is on its way and leave the rest to the SFD interrupt.
+ */
 static int
-cc2420_transmit(unsigned short payload_len)
+transmit(unsigned short payload_len, radio_tx_callback_t callback, void *ptr)
 {
   int i, txpower;
   uint8_t total_len;
@@ -349,6 +426,10 @@ cc2420_transmit(unsigned short payload_len)
   uint16_t checksum;
 #endif /* CC2420_CONF_CHECKSUM */
 
+#if WITH_ASYNC_TX
+  wait_tx();
+#endif /* WITH_ASYNC_TX */
+
   GET_LOCK();
 
   txpower = 0;
@@ -404,6 +485,34 @@ cc2420_transmit(unsigned short payload_len)
 	ENERGEST_OFF(ENERGEST_TYPE_LISTEN);
       }
       ENERGEST_ON(ENERGEST_TYPE_TRANSMIT);
+
+#if WITH_ASYNC_TX
+      if(callback != NULL) {
+        int s;
+
+        tx_ptr = ptr;
+        tx_txpower = -1;
+        if(packetbuf_attr(PACKETBUF_ATTR_RADIO_TXPOWER) > 0) {
+          tx_txpower = txpower;
+        }
+#ifdef ENERGEST_CONF_LEVELDEVICE_LEVELS
+        tx_level = cc2420_get_txpower();
+#endif
+        /* If SFD is still high, the interrupt at its falling edge
+           has yet to come and will see the callback. Otherwise the
+           frame has already been sent, and we finish it here. */
+        s = splhigh();
+        if(CC2420_SFD_IS_1) {
+          tx_callback = callback;
+          splx(s);
+          /* The lock is released by finish_tx(). */
+          return RADIO_TX_OK;
+        }
+        splx(s);
+        callback(ptr, RADIO_TX_OK);
+      }
+#endif /* WITH_ASYNC_TX */
+
       /* We wait until transmission has ended so that we get an
 	 accurate measurement of the transmission time.*/
       BUSYWAIT_UNTIL(!(status() & BV(CC2420_TX_ACTIVE)), RTIMER_SECOND / 10);
@@ -445,12 +554,34 @@ cc2420_transmit(unsigned short payload_len)
 }
 /*---------------------------------------------------------------------------*/
 static int
+cc2420_transmit(unsigned short payload_len)
+{
+  return transmit(payload_len, NULL, NULL);
+}
+/*---------------------------------------------------------------------------*/
+#if WITH_ASYNC_TX
+static int
+cc2420_transmit_async(unsigned short payload_len,
+                      radio_tx_callback_t callback, void *ptr)
+{
+  return transmit(payload_len, callback, ptr);
+}
+#endif /* WITH_ASYNC_TX */
+/*---------------------------------------------------------------------------*/
+static int
 cc2420_prepare(const void *payload, unsigned short payload_len)
 {
   uint8_t total_len;
 #if CC2420_CONF_CHECKSUM
   uint16_t checksum;
 #endif /* CC2420_CONF_CHECKSUM */
+
+#if WITH_ASYNC_TX
+  /* The TX FIFO can only hold one packet, so the frame being sent
+     must be out before the next one is written. */
+  wait_tx();
+#endif /* WITH_ASYNC_TX */
+
   GET_LOCK();
 
   PRINTF("cc2420: sending %d bytes\n", payload_len);
@@ -627,6 +758,39 @@ cc2420_interrupt(void)
   return 1;
 }
 /*---------------------------------------------------------------------------*/
+/*
+ * Called from the SFD interrupt at the falling edge of SFD, that is
+ * at the end of every frame sent or received. Returns 1 if it was
+ * the end of an asynchronous transmission.
+ */
+int
+cc2420_sfd_end_interrupt(void)
+{
+#if WITH_ASYNC_TX
+  radio_tx_callback_t callback = tx_callback;
+
+  if(callback == NULL) {
+    return 0;
+  }
+  tx_callback = NULL;
+
+#ifdef ENERGEST_CONF_LEVELDEVICE_LEVELS
+  ENERGEST_OFF_LEVEL(ENERGEST_TYPE_TRANSMIT, tx_level);
+#endif
+  ENERGEST_OFF(ENERGEST_TYPE_TRANSMIT);
+  if(receive_on) {
+    ENERGEST_ON(ENERGEST_TYPE_LISTEN);
+  }
+
+  tx_done = 1;
+  process_poll(&cc2420_process);
+  callback(tx_ptr, RADIO_TX_OK);
+  return 1;
+#else /* WITH_ASYNC_TX */
+  return 0;
+#endif /* WITH_ASYNC_TX */
+}
+/*---------------------------------------------------------------------------*/
 PROCESS_THREAD(cc2420_process, ev, data)
 {
   int len;
@@ -639,6 +803,16 @@ PROCESS_THREAD(cc2420_process, ev, data)
 #if CC2420_TIMETABLE_PROFILING
     TIMETABLE_TIMESTAMP(cc2420_timetable, "poll");
 #endif /* CC2420_TIMETABLE_PROFILING */
+
+#if WITH_ASYNC_TX
+    if(tx_done) {
+      finish_tx();
+    }
+    if(!CC2420_FIFOP_IS_1) {
+      /* Polled for the end of a transmission, nothing to read. */
+      continue;
+    }
+#endif /* WITH_ASYNC_TX */
     
     PRINTF("cc2420_process: calling receiver callback\n");
 
@@ -79,6 +79,12 @@ int cc2420_get_txpower(void);
  */
 int cc2420_interrupt(void);
 
+/**
+ * Interrupt function for the end of a frame (falling edge of SFD),
+ * called from the cc2420-arch-sfd driver.
+ */
+int cc2420_sfd_end_interrupt(void);
+
 /* XXX hack: these will be made as Chameleon packet attributes */
 extern rtimer_clock_t cc2420_time_of_arrival,
   cc2420_time_of_departure;
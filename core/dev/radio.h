@@ -55,6 +55,14 @@
 #ifndef __RADIO_H__
 #define __RADIO_H__
 
+/**
+ * Callback for the end of an asynchronous transmission, see
+ * radio_driver.transmit_async(). It is called from interrupt context
+ * with one of the RADIO_TX_ return values, and the ptr that was given
+ * to transmit_async(); it should do little more than poll a process.
+ */
+typedef void (* radio_tx_callback_t)(void *ptr, int status);
+
 /**
  * The structure of a device driver for a radio in Contiki.
  */
@@ -89,6 +97,16 @@ struct radio_driver {
 
   /** Turn the radio off. */
   int (* off)(void);
+
+  /** Start sending the packet that has previously been prepared, and
+      return without waiting for it to be sent. Returns RADIO_TX_OK if
+      the transmission was started, in which case the callback is
+      called when it has ended. The next packet may be prepared while
+      this one is being sent; transmit() and transmit_async() wait for
+      it to end before they start the next one. Optional: NULL if the
+      driver only has the blocking transmit(). */
+  int (* transmit_async)(unsigned short transmit_len,
+                         radio_tx_callback_t callback, void *ptr);
 };
 
 /* Generic radio return values. */
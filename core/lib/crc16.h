@@ -55,6 +55,29 @@
 #ifndef __CRC16_H__
 #define __CRC16_H__
 
+/*
+ * The CRC16 implementation is selected at compile time with
+ * CRC16_CONF_IMPL. All implementations compute the same checksum and
+ * differ only in speed and memory use:
+ *
+ * CRC16_SHIFT:  shifts and exclusive-ors, no tables. This is the default.
+ * CRC16_NIBBLE: a 16-entry table, 32 bytes of ROM, two lookups per byte.
+ * CRC16_TABLE:  a 256-entry table, 512 bytes of ROM, one lookup per byte.
+ * CRC16_SLICE8: the 256-entry table plus 3.5 kilobytes of RAM tables
+ *               that crc16_data() uses to process eight bytes per
+ *               step. Meant for native gateways.
+ */
+#define CRC16_SHIFT  0
+#define CRC16_NIBBLE 1
+#define CRC16_TABLE  2
+#define CRC16_SLICE8 3
+
+#ifdef CRC16_CONF_IMPL
+#define CRC16_IMPL CRC16_CONF_IMPL
+#else /* CRC16_CONF_IMPL */
+#define CRC16_IMPL CRC16_SHIFT
+#endif /* CRC16_CONF_IMPL */
+
 /**
  * \brief      Update an accumulated CRC16 checksum with one byte.
  * \param b    The byte to be added to the checksum
@@ -65,10 +88,10 @@
  *             with one byte. It can be used as a running checksum, or
  *             to checksum an entire data block.
  *
- *             \note The algorithm used in this implementation is
- *             tailored for a running checksum and does not perform as
- *             well as a table-driven algorithm when checksumming an
- *             entire data block.
+ *             \note With the default CRC16_SHIFT implementation,
+ *             this function is tailored for a running checksum and
+ *             does not perform as well as a table-driven algorithm
+ *             when checksumming an entire data block.
  *
  */
 unsigned short crc16_add(unsigned char b, unsigned short crc);
@@ -82,10 +105,9 @@ unsigned short crc16_add(unsigned char b, unsigned short crc);
  *
  *             This function calculates the CRC16 checksum of a data area.
  *
- *             \note The algorithm used in this implementation is
- *             tailored for a running checksum and does not perform as
- *             well as a table-driven algorithm when checksumming an
- *             entire data block.
+ *             \note Select CRC16_TABLE or CRC16_SLICE8 with
+ *             CRC16_CONF_IMPL when large blocks are checksummed
+ *             often and the memory is available.
  */
 unsigned short crc16_data(const unsigned char *data, int datalen,
 			  unsigned short acc);
@@ -166,3 +166,301 @@ ifft(int16_t xre[], int16_t xim[], uint16_t n)
     xre[i] = (ABS(xre[i]) + ABS(xim[i]));
   }
 }
+
+/*---------------------------------------------------------------------------*/
+/* sin(2 * pi * i / IFFT_MAX_SIZE) in Q15 for the first quarter wave */
+#if IFFT_MAX_SIZE == 64
+static const int16_t TWIDDLE_TAB[] = {
+  0, 3212, 6393, 9512, 12539, 15446, 18204, 20787,
+  23170, 25329, 27245, 28898, 30273, 31356, 32137, 32609,
+  32767
+};
+#elif IFFT_MAX_SIZE == 256
+static const int16_t TWIDDLE_TAB[] = {
+  0, 804, 1608, 2410, 3212, 4011, 4808, 5602,
+  6393, 7179, 7962, 8739, 9512, 10278, 11039, 11793,
+  12539, 13279, 14010, 14732, 15446, 16151, 16846, 17530,
+  18204, 18868, 19519, 20159, 20787, 21403, 22005, 22594,
+  23170, 23731, 24279, 24811, 25329, 25832, 26319, 26790,
+  27245, 27683, 28105, 28510, 28898, 29268, 29621, 29956,
+  30273, 30571, 30852, 31113, 31356, 31580, 31785, 31971,
+  32137, 32285, 32412, 32521, 32609, 32678, 32728, 32757,
+  32767
+};
+#elif IFFT_MAX_SIZE == 1024
+static const int16_t TWIDDLE_TAB[] = {
+  0, 201, 402, 603, 804, 1005, 1206, 1407,
+  1608, 1809, 2009, 2210, 2410, 2611, 2811, 3012,
+  3212, 3412, 3612, 3811, 4011, 4210, 4410, 4609,
+  4808, 5007, 5205, 5404, 5602, 5800, 5998, 6195,
+  6393, 6590, 6786, 6983, 7179, 7375, 7571, 7767,
+  7962, 8157, 8351, 8545, 8739, 8933, 9126, 9319,
+  9512, 9704, 9896, 10087, 10278, 10469, 10659, 10849,
+  11039, 11228, 11417, 11605, 11793, 11980, 12167, 12353,
+  12539, 12725, 12910, 13094, 13279, 13462, 13645, 13828,
+  14010, 14191, 14372, 14553, 14732, 14912, 15090, 15269,
+  15446, 15623, 15800, 15976, 16151, 16325, 16499, 16673,
+  16846, 17018, 17189, 17360, 17530, 17700, 17869, 18037,
+  18204, 18371, 18537, 18703, 18868, 19032, 19195, 19357,
+  19519, 19680, 19841, 20000, 20159, 20317, 20475, 20631,
+  20787, 20942, 21096, 21250, 21403, 21554, 21705, 21856,
+  22005, 22154, 22301, 22448, 22594, 22739, 22884, 23027,
+  23170, 23311, 23452, 23592, 23731, 23870, 24007, 24143,
+  24279, 24413, 24547, 24680, 24811, 24942, 25072, 25201,
+  25329, 25456, 25582, 25708, 25832, 25955, 26077, 26198,
+  26319, 26438, 26556, 26674, 26790, 26905, 27019, 27133,
+  27245, 27356, 27466, 27575, 27683, 27790, 27896, 28001,
+  28105, 28208, 28310, 28411, 28510, 28609, 28706, 28803,
+  28898, 28992, 29085, 29177, 29268, 29358, 29447, 29534,
+  29621, 29706, 29791, 29874, 29956, 30037, 30117, 30195,
+  30273, 30349, 30424, 30498, 30571, 30643, 30714, 30783,
+  30852, 30919, 30985, 31050, 31113, 31176, 31237, 31297,
+  31356, 31414, 31470, 31526, 31580, 31633, 31685, 31736,
+  31785, 31833, 31880, 31926, 31971, 32014, 32057, 32098,
+  32137, 32176, 32213, 32250, 32285, 32318, 32351, 32382,
+  32412, 32441, 32469, 32495, 32521, 32545, 32567, 32589,
+  32609, 32628, 32646, 32663, 32678, 32692, 32705, 32717,
+  32728, 32737, 32745, 32752, 32757, 32761, 32765, 32766,
+  32767
+};
+#else
+#error "IFFT_CONF_MAX_SIZE must be 64, 256 or 1024"
+#endif
+
+#define QUARTER (IFFT_MAX_SIZE / 4)
+
+/* The largest values that a pass may start from without overflowing:
+   a radix-2 butterfly can grow a real or imaginary part by a factor of
+   at most 1 + sqrt(2), a radix-4 pass by (1 + sqrt(2))^2, and the
+   final step of ifft_real() by 1 + sqrt(2) after it has added two
+   values. */
+#define LIMIT_RADIX2 13500
+#define LIMIT_RADIX4 5600
+#define LIMIT_SPLIT  11500
+
+/* sin(2 * pi * k / IFFT_MAX_SIZE) in Q15 */
+static int16_t
+sinQ15(uint16_t k)
+{
+  k &= IFFT_MAX_SIZE - 1;
+  if(k <= QUARTER) {
+    return TWIDDLE_TAB[k];
+  } else if(k <= 2 * QUARTER) {
+    return TWIDDLE_TAB[2 * QUARTER - k];
+  } else if(k <= 3 * QUARTER) {
+    return -TWIDDLE_TAB[k - 2 * QUARTER];
+  }
+  return -TWIDDLE_TAB[4 * QUARTER - k];
+}
+
+static int16_t
+cosQ15(uint16_t k)
+{
+  return sinQ15(k + QUARTER);
+}
+
+/* Shift the block right until no value is larger than limit, or, if
+   grow is set, left until the largest value is as close to limit as
+   possible. Returns the exponent of the shift. */
+static int
+block_scale(int16_t x[], uint16_t len, int16_t limit, int grow)
+{
+  uint16_t i;
+  int16_t v, max;
+  int shift;
+
+  max = 0;
+  for (i = 0; i < len; i++) {
+    v = x[i] < 0 ? ~x[i] : x[i];
+    if (v > max)
+      max = v;
+  }
+
+  shift = 0;
+  while (max > limit) {
+    max >>= 1;
+    shift++;
+  }
+  if (grow && max > 0) {
+    while (max <= limit / 2) {
+      max <<= 1;
+      shift--;
+    }
+  }
+
+  if (shift > 0) {
+    for (i = 0; i < len; i++)
+      x[i] >>= shift;
+  } else if (shift < 0) {
+    for (i = 0; i < len; i++)
+      x[i] = x[i] * (1 << -shift);
+  }
+  return shift;
+}
+
+/* One radix-2 pass over n complex values, combining pairs h apart */
+static void
+radix2_pass(int16_t x[], uint16_t n, uint16_t h)
+{
+  uint16_t j, g, a, b;
+  int32_t c, s, tr, ti;
+
+  for (j = 0; j < h; j++) {
+    c = cosQ15(j * (IFFT_MAX_SIZE / (2 * h)));
+    s = sinQ15(j * (IFFT_MAX_SIZE / (2 * h)));
+    for (g = j; g < n; g += 2 * h) {
+      a = 2 * g;
+      b = 2 * (g + h);
+      tr = (x[b] * c + x[b + 1] * s + 0x4000) >> 15;
+      ti = (x[b + 1] * c - x[b] * s + 0x4000) >> 15;
+      x[b] = x[a] - tr;
+      x[b + 1] = x[a + 1] - ti;
+      x[a] += tr;
+      x[a + 1] += ti;
+    }
+  }
+}
+
+#if IFFT_RADIX4
+/* Two radix-2 passes, combining values h and 2h apart, in one pass
+   over n complex values */
+static void
+radix4_pass(int16_t x[], uint16_t n, uint16_t h)
+{
+  uint16_t j, g, a, b, c, d;
+  int32_t c1, s1, c2, s2;
+  int32_t ar, ai, br, bi, cr, ci, dr, di, tr, ti;
+
+  for (j = 0; j < h; j++) {
+    c1 = cosQ15(2 * j * (IFFT_MAX_SIZE / (4 * h)));
+    s1 = sinQ15(2 * j * (IFFT_MAX_SIZE / (4 * h)));
+    c2 = cosQ15(j * (IFFT_MAX_SIZE / (4 * h)));
+    s2 = sinQ15(j * (IFFT_MAX_SIZE / (4 * h)));
+    for (g = j; g < n; g += 4 * h) {
+      a = 2 * g;
+      b = 2 * (g + h);
+      c = 2 * (g + 2 * h);
+      d = 2 * (g + 3 * h);
+
+      /* First stage: (a, b) and (c, d), twiddle W(2h, j) */
+      tr = (x[b] * c1 + x[b + 1] * s1 + 0x4000) >> 15;
+      ti = (x[b + 1] * c1 - x[b] * s1 + 0x4000) >> 15;
+      ar = x[a] + tr;
+      ai = x[a + 1] + ti;
+      br = x[a] - tr;
+      bi = x[a + 1] - ti;
+      tr = (x[d] * c1 + x[d + 1] * s1 + 0x4000) >> 15;
+      ti = (x[d + 1] * c1 - x[d] * s1 + 0x4000) >> 15;
+      cr = x[c] + tr;
+      ci = x[c + 1] + ti;
+      dr = x[c] - tr;
+      di = x[c + 1] - ti;
+
+      /* Second stage: (a, c) with twiddle W(4h, j), and (b, d) with
+         W(4h, j + h) = -i * W(4h, j) */
+      tr = (cr * c2 + ci * s2 + 0x4000) >> 15;
+      ti = (ci * c2 - cr * s2 + 0x4000) >> 15;
+      x[a] = ar + tr;
+      x[a + 1] = ai + ti;
+      x[c] = ar - tr;
+      x[c + 1] = ai - ti;
+      tr = (di * c2 - dr * s2 + 0x4000) >> 15;
+      ti = -((dr * c2 + di * s2 + 0x4000) >> 15);
+      x[b] = br + tr;
+      x[b + 1] = bi + ti;
+      x[d] = br - tr;
+      x[d + 1] = bi - ti;
+    }
+  }
+}
+#endif /* IFFT_RADIX4 */
+
+int
+ifft_complex(int16_t x[], uint16_t n)
+{
+  uint16_t i, j, k, h;
+  int16_t t;
+  int exp;
+
+  /* Put the samples in bit-reversed order. */
+  for (i = 0, j = 0; i < n - 1; i++) {
+    if (i < j) {
+      t = x[2 * i];
+      x[2 * i] = x[2 * j];
+      x[2 * j] = t;
+      t = x[2 * i + 1];
+      x[2 * i + 1] = x[2 * j + 1];
+      x[2 * j + 1] = t;
+    }
+    k = n >> 1;
+    while (j & k) {
+      j ^= k;
+      k >>= 1;
+    }
+    j |= k;
+  }
+
+  /* The first pass may also scale small inputs up. */
+  exp = 0;
+  h = 1;
+#if IFFT_RADIX4
+  if (ilog2(n) & 1) {
+    exp += block_scale(x, 2 * n, LIMIT_RADIX2, h == 1);
+    radix2_pass(x, n, h);
+    h = 2;
+  }
+  for (; h < n; h *= 4) {
+    exp += block_scale(x, 2 * n, LIMIT_RADIX4, h == 1);
+    radix4_pass(x, n, h);
+  }
+#else /* IFFT_RADIX4 */
+  for (; h < n; h *= 2) {
+    exp += block_scale(x, 2 * n, LIMIT_RADIX2, h == 1);
+    radix2_pass(x, n, h);
+  }
+#endif /* IFFT_RADIX4 */
+  return exp;
+}
+
+int
+ifft_real(int16_t x[], uint16_t n)
+{
+  uint16_t m, k, nk;
+  int32_t c, s, fer, fei, for_, foi, tr, ti;
+  int16_t zr;
+  int exp;
+
+  /* Transform the even samples as the real parts and the odd samples as
+     the imaginary parts of n/2 complex samples. */
+  m = n / 2;
+  exp = ifft_complex(x, m);
+  exp += block_scale(x, n, LIMIT_SPLIT, 0);
+
+  /* Separate the spectra of the even and the odd samples, E and O,
+     and combine them into bin k = E(k) + W(n, k) * O(k), using that
+     bin m - k is the complex conjugate of E(k) - W(n, k) * O(k). */
+  zr = x[0];
+  x[0] = zr + x[1];
+  x[1] = zr - x[1];
+  for (k = 1; k <= m / 2; k++) {
+    nk = m - k;
+    /* Twice E(k) and twice O(k) */
+    fer = (int32_t)x[2 * k] + x[2 * nk];
+    fei = (int32_t)x[2 * k + 1] - x[2 * nk + 1];
+    for_ = (int32_t)x[2 * k + 1] + x[2 * nk + 1];
+    foi = (int32_t)x[2 * nk] - x[2 * k];
+
+    c = cosQ15(k * (IFFT_MAX_SIZE / n));
+    s = sinQ15(k * (IFFT_MAX_SIZE / n));
+    tr = (for_ * c + foi * s + 0x4000) >> 15;
+    ti = (foi * c - for_ * s + 0x4000) >> 15;
+
+    x[2 * k] = (fer + tr + 1) >> 1;
+    x[2 * k + 1] = (fei + ti + 1) >> 1;
+    if (nk != k) {
+      x[2 * nk] = (fer - tr + 1) >> 1;
+      x[2 * nk + 1] = (ti - fei + 1) >> 1;
+    }
+  }
+  return exp;
+}
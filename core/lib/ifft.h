@@ -55,4 +55,49 @@
 */
 void ifft(int16_t xre[], int16_t xim[], uint16_t n);
 
+/* The largest transform that ifft_complex() and ifft_real() support:
+   64, 256 or 1024 points. The twiddle factors are read from a ROM
+   table of IFFT_MAX_SIZE / 4 + 1 16-bit values. */
+#ifdef IFFT_CONF_MAX_SIZE
+#define IFFT_MAX_SIZE IFFT_CONF_MAX_SIZE
+#else
+#define IFFT_MAX_SIZE 256
+#endif
+
+/* Combine pairs of radix-2 stages into radix-4 passes, which halves
+   the number of passes over the data at the cost of some code size. */
+#ifdef IFFT_CONF_RADIX4
+#define IFFT_RADIX4 IFFT_CONF_RADIX4
+#else
+#define IFFT_RADIX4 1
+#endif
+
+/* ifft_complex(x[], n) - fixed-point complex FFT with block floating point
+   Transforms n complex samples, stored as interleaved real and
+   imaginary parts in x[0 .. 2n-1], in place. n must be a power of two
+   no larger than IFFT_MAX_SIZE.
+
+   The samples may use the full 16-bit range. Before every pass, the
+   whole block is shifted right just enough that the pass cannot
+   overflow, and small inputs are first shifted left to use all 16
+   bits. The returned exponent e tells how the result is scaled: the
+   transform is x[] * 2^e.
+*/
+int ifft_complex(int16_t x[], uint16_t n);
+
+/* ifft_real(x[], n) - fixed-point FFT of real samples
+   Transforms n real samples in x[] in place, using a complex FFT of
+   n/2 points. n must be a power of two, at least 4, and no larger than
+   IFFT_MAX_SIZE. Only the first half of the spectrum is stored, as the
+   second half is its mirror image:
+
+     x[0]             real part of bin 0 (its imaginary part is zero)
+     x[1]             real part of bin n/2 (its imaginary part is zero)
+     x[2k], x[2k+1]   real and imaginary parts of bin k, 0 < k < n/2
+
+   As with ifft_complex(), the transform is x[] * 2^e, where e is the
+   returned exponent.
+*/
+int ifft_real(int16_t x[], uint16_t n);
+
 #endif /* IFFT_H */
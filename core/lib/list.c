@@ -327,4 +327,168 @@ list_item_next(void *item)
   return item == NULL? NULL: ((struct list *)item)->next;
 }
 /*---------------------------------------------------------------------------*/
+/* A list declared with LIST_TAIL() points to two pointers: the first
+   and the last element. */
+#define LAST(list) ((list)[1])
+/*---------------------------------------------------------------------------*/
+/**
+ * Initialize a list declared with LIST_TAIL().
+ *
+ * \param list The list to be initialized.
+ */
+void
+list_tail_init(list_t list)
+{
+  *list = NULL;
+  LAST(list) = NULL;
+}
+/*---------------------------------------------------------------------------*/
+/**
+ * Get the last element of a list declared with LIST_TAIL().
+ *
+ * Unlike list_tail(), this function does not walk the list.
+ *
+ * \param list The list.
+ * \return A pointer to the last element on the list.
+ */
+void *
+list_tail_last(list_t list)
+{
+  return LAST(list);
+}
+/*---------------------------------------------------------------------------*/
+/**
+ * Add an item at the end of a list declared with LIST_TAIL().
+ *
+ * Unlike list_add(), this function does not walk the list, and
+ * therefore does not check whether the item already is on the list.
+ * The item \b must not be on the list, unless it is the last one.
+ *
+ * \param list The list.
+ * \param item A pointer to the item to be added.
+ */
+void
+list_tail_add(list_t list, void *item)
+{
+  if(item == LAST(list)) {
+    return;
+  }
+
+  ((struct list *)item)->next = NULL;
+
+  if(*list == NULL) {
+    *list = item;
+  } else {
+    ((struct list *)LAST(list))->next = item;
+  }
+  LAST(list) = item;
+}
+/*---------------------------------------------------------------------------*/
+/**
+ * Add an item to the start of a list declared with LIST_TAIL().
+ *
+ * The item \b must not be on the list.
+ */
+void
+list_tail_push(list_t list, void *item)
+{
+  ((struct list *)item)->next = *list;
+  *list = item;
+  if(LAST(list) == NULL) {
+    LAST(list) = item;
+  }
+}
+/*---------------------------------------------------------------------------*/
+/**
+ * Remove the first object on a list declared with LIST_TAIL().
+ *
+ * \param list The list.
+ * \return Pointer to the removed element of list.
+ */
+void *
+list_tail_pop(list_t list)
+{
+  struct list *l;
+
+  l = list_pop(list);
+  if(*list == NULL) {
+    LAST(list) = NULL;
+  }
+  return l;
+}
+/*---------------------------------------------------------------------------*/
+/**
+ * Remove a specific element from a list declared with LIST_TAIL().
+ *
+ * \param list The list.
+ * \param item The item that is to be removed from the list.
+ */
+void
+list_tail_remove(list_t list, void *item)
+{
+  struct list *l, *r;
+
+  r = NULL;
+  for(l = *list; l != NULL; l = l->next) {
+    if(l == item) {
+      if(r == NULL) {
+	*list = l->next;
+      } else {
+	r->next = l->next;
+      }
+      if(LAST(list) == l) {
+	LAST(list) = r;
+      }
+      l->next = NULL;
+      return;
+    }
+    r = l;
+  }
+}
+/*---------------------------------------------------------------------------*/
+/**
+ * Remove the last object on a list declared with LIST_TAIL().
+ *
+ * The list is singly linked, so the element before the last one is
+ * still found by walking the list.
+ *
+ * \param list The list
+ * \return The removed object
+ */
+void *
+list_tail_chop(list_t list)
+{
+  void *l;
+
+  l = LAST(list);
+  if(l != NULL) {
+    list_tail_remove(list, l);
+  }
+  return l;
+}
+/*---------------------------------------------------------------------------*/
+/**
+ * Insert an item after a specified item on a list declared with
+ * LIST_TAIL().
+ *
+ * \param list The list
+ * \param previtem The item after which the new item should be inserted
+ * \param newitem  The new item that is to be inserted
+ *
+ * \sa list_insert()
+ */
+void
+list_tail_insert(list_t list, void *previtem, void *newitem)
+{
+  if(previtem == NULL) {
+    list_tail_push(list, newitem);
+  } else {
+    ((struct list *)newitem)->next = ((struct list *)previtem)->next;
+    ((struct list *)previtem)->next = newitem;
+    if(LAST(list) == previtem) {
+      LAST(list) = newitem;
+    }
+  }
+}
+/*---------------------------------------------------------------------------*/
 /** @} */
@@ -129,6 +129,52 @@
        list_init((struct_ptr)->name);                                   \
     } while(0)
 
+/**
+ * Declare a linked list that keeps track of its last element.
+ *
+ * This macro declares a linked list that, besides the pointer to the
+ * first element, holds a pointer to the last element. Elements can
+ * then be appended with list_tail_add() and the last element found
+ * with list_tail_last() without walking the list.
+ *
+ * The functions that only read a list, e.g. list_head(),
+ * list_length() and list_item_next(), work on such a list as on any
+ * other. A list declared with LIST_TAIL() must only be modified with
+ * the list_tail_*() functions, or the pointer to its last element
+ * goes stale.
+ *
+ * \param name The name of the list.
+ */
+#define LIST_TAIL(name) \
+         static void *LIST_CONCAT(name,_list)[2] = {NULL, NULL}; \
+         static list_t name = (list_t)LIST_CONCAT(name,_list)
+
+/**
+ * Declare a linked list that keeps track of its last element inside
+ * a structure declaration.
+ *
+ * The list is initialized with the LIST_TAIL_STRUCT_INIT() macro.
+ *
+ * \param name The name of the list.
+ * \sa LIST_TAIL(), LIST_STRUCT()
+ */
+#define LIST_TAIL_STRUCT(name) \
+         void *LIST_CONCAT(name,_list)[2]; \
+         list_t name
+
+/**
+ * Initialize a linked list, declared with LIST_TAIL_STRUCT(), that is
+ * part of a structure.
+ *
+ * \param struct_ptr A pointer to the struct
+ * \param name The name of the list.
+ */
+#define LIST_TAIL_STRUCT_INIT(struct_ptr, name)                         \
+    do {                                                                \
+       (struct_ptr)->name = (struct_ptr)->LIST_CONCAT(name,_list);      \
+       list_tail_init((struct_ptr)->name);                              \
+    } while(0)
+
 /**
  * The linked list type.
  *
@@ -154,6 +200,15 @@ void   list_insert(list_t list, void *previtem, void *newitem);
 
 void * list_item_next(void *item);
 
+void   list_tail_init(list_t list);
+void * list_tail_last(list_t list);
+void   list_tail_add(list_t list, void *item);
+void   list_tail_push(list_t list, void *item);
+void * list_tail_pop(list_t list);
+void * list_tail_chop(list_t list);
+void   list_tail_remove(list_t list, void *item);
+void   list_tail_insert(list_t list, void *previtem, void *newitem);
+
 #endif /* __LIST_H__ */
 
 /** @} */
@@ -48,40 +48,173 @@
 #include "contiki.h"
 #include "lib/memb.h"
 
+#if MEMB_STATS
+static struct memb *pools;
+#endif /* MEMB_STATS */
+
+#if MEMB_FREELIST
+/* A free block holds the address of the next free block in its first
+   bytes. The blocks need not be aligned for a pointer, so the link is
+   copied rather than dereferenced. */
+#define HAS_FREELIST(m) ((m)->size >= sizeof(void *))
+#endif /* MEMB_FREELIST */
+
+/*---------------------------------------------------------------------------*/
+#if MEMB_FREELIST
+static void
+build_freelist(struct memb *m)
+{
+  int i;
+  char *block;
+
+  m->free = NULL;
+  for(i = m->num - 1; i >= 0; --i) {
+    if(m->count[i] == 0) {
+      block = (char *)m->mem + i * m->size;
+      memcpy(block, &m->free, sizeof(void *));
+      m->free = block;
+    }
+  }
+}
+#endif /* MEMB_FREELIST */
+/*---------------------------------------------------------------------------*/
+#if MEMB_STATS
+static void
+add_pool(struct memb *m)
+{
+  struct memb *p;
+
+  for(p = pools; p != NULL; p = p->next) {
+    if(p == m) {
+      return;
+    }
+  }
+  m->next = pools;
+  pools = m;
+}
+/*---------------------------------------------------------------------------*/
+struct memb *
+memb_pools(void)
+{
+  return pools;
+}
+#endif /* MEMB_STATS */
 /*---------------------------------------------------------------------------*/
 void
 memb_init(struct memb *m)
 {
   memset(m->count, 0, m->num);
   memset(m->mem, 0, m->size * m->num);
+#if MEMB_FREELIST || MEMB_STATS
+  m->used = 0;
+#endif /* MEMB_FREELIST || MEMB_STATS */
+#if MEMB_FREELIST
+  if(HAS_FREELIST(m)) {
+    build_freelist(m);
+  }
+#endif /* MEMB_FREELIST */
+#if MEMB_STATS
+  add_pool(m);
+#endif /* MEMB_STATS */
 }
 /*---------------------------------------------------------------------------*/
+#if MEMB_FREELIST || MEMB_STATS
+static void *
+allocated(struct memb *m, void *block)
+{
+#if MEMB_STATS
+  if(m->max_used == 0 && m->failed == 0) {
+    /* first allocation; the block may not have been initialized */
+    add_pool(m);
+  }
+  if(block == NULL) {
+    ++m->failed;
+    return NULL;
+  }
+  if(++m->used > m->max_used) {
+    m->max_used = m->used;
+  }
+#else /* MEMB_STATS */
+  if(block != NULL) {
+    ++m->used;
+  }
+#endif /* MEMB_STATS */
+  return block;
+}
+#else /* MEMB_FREELIST || MEMB_STATS */
+#define allocated(m, block) (block)
+#endif /* MEMB_FREELIST || MEMB_STATS */
+/*---------------------------------------------------------------------------*/
 void *
 memb_alloc(struct memb *m)
 {
   int i;
 
+#if MEMB_FREELIST
+  if(HAS_FREELIST(m)) {
+    char *block;
+
+    /* Blocks that were never initialized with memb_init() are all
+       free, but not yet on the list. */
+    if(m->free == NULL && m->used == 0) {
+      build_freelist(m);
+    }
+
+    block = m->free;
+    if(block != NULL) {
+      memcpy(&m->free, block, sizeof(void *));
+      /* Hand out the block as memb_init() left it. */
+      memset(block, 0, sizeof(void *));
+      m->count[(block - (char *)m->mem) / m->size] = 1;
+    }
+    return allocated(m, block);
+  }
+#endif /* MEMB_FREELIST */
+
   for(i = 0; i < m->num; ++i) {
     if(m->count[i] == 0) {
       /* If this block was unused, we increase the reference count to
 	 indicate that it now is used and return a pointer to the
 	 memory block. */
       ++(m->count[i]);
-      return (void *)((char *)m->mem + (i * m->size));
+      return allocated(m, (void *)((char *)m->mem + (i * m->size)));
     }
   }
 
   /* No free block was found, so we return NULL to indicate failure to
      allocate block. */
-  return NULL;
+  return allocated(m, NULL);
 }
 /*---------------------------------------------------------------------------*/
 char
 memb_free(struct memb *m, void *ptr)
 {
   int i;
+#if !(MEMB_FREELIST || MEMB_STATS)
   char *ptr2;
+#endif /* !(MEMB_FREELIST || MEMB_STATS) */
 
+#if MEMB_FREELIST || MEMB_STATS
+  /* The block can be found directly from its offset. */
+  if(!memb_inmemb(m, ptr) ||
+     ((char *)ptr - (char *)m->mem) % m->size != 0) {
+    return -1;
+  }
+  i = ((char *)ptr - (char *)m->mem) / m->size;
+  if(m->count[i] > 0) {
+    /* Make sure that we don't deallocate free memory. */
+    if(--(m->count[i]) == 0) {
+      --m->used;
+#if MEMB_FREELIST
+      if(HAS_FREELIST(m)) {
+        memcpy(ptr, &m->free, sizeof(void *));
+        m->free = ptr;
+      }
+#endif /* MEMB_FREELIST */
+    }
+  }
+  return m->count[i];
+#else /* MEMB_FREELIST || MEMB_STATS */
   /* Walk through the list of blocks and try to find the block to
      which the pointer "ptr" points to. */
   ptr2 = (char *)m->mem;
@@ -99,6 +232,7 @@ memb_free(struct memb *m, void *ptr)
     ptr2 += m->size;
   }
   return -1;
+#endif /* MEMB_FREELIST || MEMB_STATS */
 }
 /*---------------------------------------------------------------------------*/
 int
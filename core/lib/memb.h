@@ -64,8 +64,40 @@
 #ifndef __MEMB_H__
 #define __MEMB_H__
 
+#include "contiki-conf.h"
 #include "sys/cc.h"
 
+/**
+ * If set, free blocks are kept on a list threaded through the blocks
+ * themselves, so that memb_alloc() and memb_free() run in constant
+ * time instead of scanning the block array. Pools whose blocks are
+ * smaller than a pointer are still scanned. A block must not be used
+ * after it has been freed, e.g. still be on a list, since its first
+ * bytes are overwritten.
+ */
+#ifdef MEMB_CONF_FREELIST
+#define MEMB_FREELIST MEMB_CONF_FREELIST
+#else
+#define MEMB_FREELIST 0
+#endif
+
+/**
+ * If set, each memory block keeps track of how many blocks are in
+ * use, the highest number ever in use and the number of failed
+ * allocations. Initialized blocks can be listed with memb_pools().
+ */
+#ifdef MEMB_CONF_STATS
+#define MEMB_STATS MEMB_CONF_STATS
+#else
+#define MEMB_STATS 0
+#endif
+
+#if MEMB_STATS
+#define MEMB_NAME(name) , #name
+#else
+#define MEMB_NAME(name)
+#endif
+
 /**
  * Declare a memory block.
  *
@@ -92,13 +124,26 @@ MEMB(connections, struct connection, 16);
         static structure CC_CONCAT(name,_memb_mem)[num]; \
         static struct memb name = {sizeof(structure), num, \
                                           CC_CONCAT(name,_memb_count), \
-                                          (void *)CC_CONCAT(name,_memb_mem)}
+                                          (void *)CC_CONCAT(name,_memb_mem) \
+                                          MEMB_NAME(name)}
 
 struct memb {
   unsigned short size;
   unsigned short num;
   char *count;
   void *mem;
+#if MEMB_STATS
+  const char *name;
+  struct memb *next;
+  unsigned short max_used;
+  unsigned short failed;
+#endif /* MEMB_STATS */
+#if MEMB_FREELIST || MEMB_STATS
+  unsigned short used;
+#endif /* MEMB_FREELIST || MEMB_STATS */
+#if MEMB_FREELIST
+  void *free;
+#endif /* MEMB_FREELIST */
 };
 
 /**
@@ -131,6 +176,14 @@ char  memb_free(struct memb *m, void *ptr);
 
 int memb_inmemb(struct memb *m, void *ptr);
 
+#if MEMB_STATS
+/**
+ * Get the first of the memory blocks that have been initialized or
+ * allocated from. The rest follow through the next field.
+ */
+struct memb *memb_pools(void);
+#endif /* MEMB_STATS */
+
 
 /** @} */
 /** @} */
@@ -56,10 +56,26 @@
 #define MMEM_SIZE 4096
 #endif
 
+/* Defer compaction until an allocation does not fit, or until
+   mmem_compact() is called, instead of compacting on every free. */
+#ifdef MMEM_CONF_DEFERRED
+#define MMEM_DEFERRED MMEM_CONF_DEFERRED
+#else
+#define MMEM_DEFERRED 0
+#endif
+
 LIST(mmemlist);
 unsigned int avail_memory;
+unsigned long mmem_bytes_moved;
 static char memory[MMEM_SIZE];
 
+#if MMEM_DEFERRED
+/* The end of the topmost block. The free memory consists of the space
+   above it and the holes left by freed blocks below it. The blocks on
+   mmemlist are kept in address order. */
+static unsigned int top;
+#endif /* MMEM_DEFERRED */
+
 /*---------------------------------------------------------------------------*/
 /**
  * \brief      Allocate a managed memory block
@@ -79,6 +95,12 @@ static char memory[MMEM_SIZE];
  *             macro MMEM_PTR() is used to get a pointer to the
  *             allocated memory.
  *
+ *             \note Allocated blocks may be moved, so a pointer
+ *             obtained with MMEM_PTR() is invalidated by
+ *             mmem_alloc(), mmem_free() and mmem_compact(). With
+ *             MMEM_CONF_DEFERRED, this function compacts all blocks
+ *             when the new one does not fit above the topmost block.
+ *
  */
 int
 mmem_alloc(struct mmem *m, unsigned int size)
@@ -88,6 +110,18 @@ mmem_alloc(struct mmem *m, unsigned int size)
     return 0;
   }
 
+#if MMEM_DEFERRED
+  if(MMEM_SIZE - top < size) {
+    /* Enough memory is free, but some of it is in holes. */
+    mmem_compact(MMEM_SIZE);
+  }
+
+  list_add(mmemlist, m);
+  m->ptr = &memory[top];
+  m->size = size;
+  top += size;
+  avail_memory -= size;
+#else /* MMEM_DEFERRED */
   /* We had enough memory so we add this memory block to the end of
      the list of allocated memory blocks. */
   list_add(mmemlist, m);
@@ -101,6 +135,7 @@ mmem_alloc(struct mmem *m, unsigned int size)
 
   /* Decrease the amount of available memory. */
   avail_memory -= size;
+#endif /* MMEM_DEFERRED */
 
   /* Return non-zero to indicate that we were able to allocate
      memory. */
@@ -121,11 +156,24 @@ mmem_free(struct mmem *m)
 {
   struct mmem *n;
 
+#if MMEM_DEFERRED
+  n = m->next;
+  avail_memory += m->size;
+  list_remove(mmemlist, m);
+  if(n == NULL) {
+    /* The topmost block, and any holes below it, go back to the free
+       space at the top. */
+    n = list_tail(mmemlist);
+    top = n == NULL ? 0 : (char *)n->ptr + n->size - memory;
+  }
+#else /* MMEM_DEFERRED */
   if(m->next != NULL) {
     /* Compact the memory after the allocation that is to be removed
        by moving it downwards. */
     memmove(m->ptr, m->next->ptr,
 	    &memory[MMEM_SIZE - avail_memory] - (char *)m->next->ptr);
+    mmem_bytes_moved += &memory[MMEM_SIZE - avail_memory] -
+      (char *)m->next->ptr;
     
     /* Update all the memory pointers that points to memory that is
        after the allocation that is to be removed. */
@@ -138,6 +186,7 @@ mmem_free(struct mmem *m)
 
   /* Remove the memory block from the list. */
   list_remove(mmemlist, m);
+#endif /* MMEM_DEFERRED */
 }
 /*---------------------------------------------------------------------------*/
 /**
@@ -154,6 +203,46 @@ mmem_init(void)
 {
   list_init(mmemlist);
   avail_memory = MMEM_SIZE;
+  mmem_bytes_moved = 0;
+#if MMEM_DEFERRED
+  top = 0;
+#endif /* MMEM_DEFERRED */
+}
+/*---------------------------------------------------------------------------*/
+int
+mmem_compact(unsigned int max)
+{
+#if MMEM_DEFERRED
+  struct mmem *m;
+  unsigned int end, moved;
+
+  end = 0;
+  moved = 0;
+  for(m = list_head(mmemlist); m != NULL && moved < max; m = m->next) {
+    if((char *)m->ptr != &memory[end]) {
+      memmove(&memory[end], m->ptr, m->size);
+      m->ptr = &memory[end];
+      moved += m->size;
+    }
+    end += m->size;
+  }
+  mmem_bytes_moved += moved;
+
+  if(m == NULL) {
+    top = end;
+  }
+#endif /* MMEM_DEFERRED */
+  return mmem_fragmented() > 0;
+}
+/*---------------------------------------------------------------------------*/
+unsigned int
+mmem_fragmented(void)
+{
+#if MMEM_DEFERRED
+  return avail_memory - (MMEM_SIZE - top);
+#else /* MMEM_DEFERRED */
+  return 0;
+#endif /* MMEM_DEFERRED */
 }
 /*---------------------------------------------------------------------------*/
 
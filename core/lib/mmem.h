@@ -88,6 +88,31 @@ int  mmem_alloc(struct mmem *m, unsigned int size);
 void mmem_free(struct mmem *);
 void mmem_init(void);
 
+/**
+ * \brief      Move allocated blocks down over freed space
+ * \param max  Stop after this many bytes have been moved
+ * \return     Non-zero if freed space remains below allocated blocks
+ *
+ *             With MMEM_CONF_DEFERRED, mmem_free() leaves a hole
+ *             behind unless the block was the topmost one, and the
+ *             holes are compacted when an allocation does not fit
+ *             above the topmost block. This function compacts them
+ *             in bounded steps instead, e.g. from an idle loop. A
+ *             block is always moved as a whole, so a step may move
+ *             more than max bytes. Like mmem_alloc() and mmem_free(),
+ *             it invalidates pointers obtained with MMEM_PTR().
+ */
+int  mmem_compact(unsigned int max);
+
+/**
+ * \brief      Get the amount of free memory lying in holes
+ * \return     The number of free bytes below the topmost block
+ */
+unsigned int mmem_fragmented(void);
+
+/** The number of bytes moved by compaction since mmem_init(). */
+extern unsigned long mmem_bytes_moved;
+
 #endif /* __MMEM_H__ */
 
 /** @} */
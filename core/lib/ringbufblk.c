@@ -0,0 +1,172 @@
+/*
+ * Copyright (c) 2013, Swedish Institute of Computer Science.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the Institute nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE INSTITUTE AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE INSTITUTE OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ *
+ * This file is part of the Contiki operating system.
+ */
+
+
+/**
+ * \file
+ *         Block ring buffer library implementation
+ */
+
+#include <string.h>
+
+#include "lib/ringbufblk.h"
+
+/* Keep the compiler from moving accesses to the elements across the
+   index updates that hand them over to the other side. */
+#ifdef __GNUC__
+#define BARRIER() __asm__ __volatile__("" : : : "memory")
+#else
+#define BARRIER()
+#endif
+
+#define ELEM(r, i) ((r)->data + ((i) & (r)->mask) * (r)->elem_size)
+/*---------------------------------------------------------------------------*/
+void
+ringbufblk_init(struct ringbufblk *r, void *data,
+                unsigned int elem_size, ringbufblk_index_t num)
+{
+  r->data = data;
+  r->elem_size = elem_size;
+  r->mask = num - 1;
+  r->put_ptr = 0;
+  r->get_ptr = 0;
+}
+/*---------------------------------------------------------------------------*/
+ringbufblk_index_t
+ringbufblk_elements(struct ringbufblk *r)
+{
+  return (ringbufblk_index_t)(r->put_ptr - r->get_ptr);
+}
+/*---------------------------------------------------------------------------*/
+ringbufblk_index_t
+ringbufblk_space(struct ringbufblk *r)
+{
+  return (ringbufblk_index_t)(r->mask + 1 - ringbufblk_elements(r));
+}
+/*---------------------------------------------------------------------------*/
+ringbufblk_index_t
+ringbufblk_peek(struct ringbufblk *r, void **elems)
+{
+  ringbufblk_index_t n, get, to_end;
+
+  get = r->get_ptr;
+  n = (ringbufblk_index_t)(r->put_ptr - get);
+  BARRIER();
+  to_end = (ringbufblk_index_t)(r->mask + 1 - (get & r->mask));
+  *elems = ELEM(r, get);
+  return n < to_end ? n : to_end;
+}
+/*---------------------------------------------------------------------------*/
+void
+ringbufblk_consume(struct ringbufblk *r, ringbufblk_index_t num)
+{
+  BARRIER();
+  r->get_ptr += num;
+}
+/*---------------------------------------------------------------------------*/
+ringbufblk_index_t
+ringbufblk_reserve(struct ringbufblk *r, void **elems)
+{
+  ringbufblk_index_t n, put, to_end;
+
+  put = r->put_ptr;
+  n = (ringbufblk_index_t)(r->mask + 1 -
+                           (ringbufblk_index_t)(put - r->get_ptr));
+  BARRIER();
+  to_end = (ringbufblk_index_t)(r->mask + 1 - (put & r->mask));
+  *elems = ELEM(r, put);
+  return n < to_end ? n : to_end;
+}
+/*---------------------------------------------------------------------------*/
+void
+ringbufblk_commit(struct ringbufblk *r, ringbufblk_index_t num)
+{
+  BARRIER();
+  r->put_ptr += num;
+}
+/*---------------------------------------------------------------------------*/
+ringbufblk_index_t
+ringbufblk_put_block(struct ringbufblk *r, const void *elems,
+                     ringbufblk_index_t num)
+{
+  ringbufblk_index_t done, n;
+  void *p;
+
+  /* The free space wraps around the end of the array at most once. */
+  for(done = 0; done < num; done += n) {
+    n = ringbufblk_reserve(r, &p);
+    if(n == 0) {
+      break;
+    }
+    if(n > num - done) {
+      n = num - done;
+    }
+    memcpy(p, (const uint8_t *)elems + done * r->elem_size,
+           n * r->elem_size);
+    ringbufblk_commit(r, n);
+  }
+  return done;
+}
+/*---------------------------------------------------------------------------*/
+ringbufblk_index_t
+ringbufblk_get_block(struct ringbufblk *r, void *elems,
+                     ringbufblk_index_t num)
+{
+  ringbufblk_index_t done, n;
+  void *p;
+
+  for(done = 0; done < num; done += n) {
+    n = ringbufblk_peek(r, &p);
+    if(n == 0) {
+      break;
+    }
+    if(n > num - done) {
+      n = num - done;
+    }
+    memcpy((uint8_t *)elems + done * r->elem_size, p,
+           n * r->elem_size);
+    ringbufblk_consume(r, n);
+  }
+  return done;
+}
+/*---------------------------------------------------------------------------*/
+int
+ringbufblk_put(struct ringbufblk *r, const void *elem)
+{
+  return ringbufblk_put_block(r, elem, 1);
+}
+/*---------------------------------------------------------------------------*/
+int
+ringbufblk_get(struct ringbufblk *r, void *elem)
+{
+  return ringbufblk_get_block(r, elem, 1);
+}
+/*---------------------------------------------------------------------------*/
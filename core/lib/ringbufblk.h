@@ -0,0 +1,195 @@
+/*
+ * Copyright (c) 2013, Swedish Institute of Computer Science.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the Institute nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE INSTITUTE AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE INSTITUTE OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ *
+ * This file is part of the Contiki operating system.
+ */
+
+
+/** \addtogroup lib
+ * @{ */
+
+/**
+ * \defgroup ringbufblk Block ring buffer library
+ * @{
+ *
+ * A single-producer, single-consumer ring buffer of fixed-size
+ * elements. Unlike the \ref ringbuf "ring buffer library", elements
+ * may be larger than a byte, the buffer may hold more than 128 of
+ * them, and whole blocks of elements can be moved with one call or
+ * accessed in place.
+ *
+ * One side, e.g. an interrupt handler, may put elements while the
+ * other, e.g. a protothread, gets them, without disabling
+ * interrupts. Each side only writes its own index, and the indices
+ * must be read and written atomically, which is the case for an
+ * unsigned int on 16- and 32-bit CPUs. Platforms where it is not, such
+ * as 8-bit AVR, set RINGBUFBLK_CONF_INDEX_TYPE to uint8_t and keep
+ * buffers to at most 128 elements.
+ */
+
+/**
+ * \file
+ *         Header file for the block ring buffer library
+ */
+
+#ifndef __RINGBUFBLK_H__
+#define __RINGBUFBLK_H__
+
+#include "contiki-conf.h"
+
+#ifdef RINGBUFBLK_CONF_INDEX_TYPE
+typedef RINGBUFBLK_CONF_INDEX_TYPE ringbufblk_index_t;
+#else
+typedef unsigned int ringbufblk_index_t;
+#endif
+
+/**
+ * \brief      Structure that holds the state of a block ring buffer.
+ *
+ *             The elements are stored in a separately defined
+ *             array. This struct is an opaque structure with no
+ *             user-visible elements.
+ */
+struct ringbufblk {
+  uint8_t *data;
+  unsigned int elem_size;
+  ringbufblk_index_t mask;
+
+  /* Free-running counts of the elements put and got. Each is written
+     by one side only. */
+  volatile ringbufblk_index_t put_ptr, get_ptr;
+};
+
+/**
+ * \brief      Initialize a block ring buffer
+ * \param r    A pointer to a struct ringbufblk
+ * \param data An array of num * elem_size bytes to hold the elements
+ * \param elem_size The size of an element in bytes
+ * \param num  The number of elements, which must be a power of two
+ */
+void ringbufblk_init(struct ringbufblk *r, void *data,
+                     unsigned int elem_size, ringbufblk_index_t num);
+
+/**
+ * \brief      Put an element into a block ring buffer
+ * \param r    A pointer to a struct ringbufblk
+ * \param elem A pointer to the element
+ * \return     Non-zero if the element was put, zero if the buffer was full
+ */
+int ringbufblk_put(struct ringbufblk *r, const void *elem);
+
+/**
+ * \brief      Get an element from a block ring buffer
+ * \param r    A pointer to a struct ringbufblk
+ * \param elem A pointer to where the element is copied
+ * \return     Non-zero if an element was got, zero if the buffer was empty
+ */
+int ringbufblk_get(struct ringbufblk *r, void *elem);
+
+/**
+ * \brief      Put a number of elements into a block ring buffer
+ * \param r    A pointer to a struct ringbufblk
+ * \param elems A pointer to the elements
+ * \param num  The number of elements
+ * \return     The number of elements put, which is less than num if
+ *             the buffer became full
+ */
+ringbufblk_index_t ringbufblk_put_block(struct ringbufblk *r,
+                                        const void *elems,
+                                        ringbufblk_index_t num);
+
+/**
+ * \brief      Get a number of elements from a block ring buffer
+ * \param r    A pointer to a struct ringbufblk
+ * \param elems A pointer to where the elements are copied
+ * \param num  The largest number of elements to get
+ * \return     The number of elements got
+ */
+ringbufblk_index_t ringbufblk_get_block(struct ringbufblk *r,
+                                        void *elems,
+                                        ringbufblk_index_t num);
+
+/**
+ * \brief      Get the elements that can be read in place
+ * \param r    A pointer to a struct ringbufblk
+ * \param elems Set to point to the first element in the buffer
+ * \return     The number of elements, stored one after another, from
+ *             *elems on
+ *
+ *             The elements stay in the buffer until they are removed
+ *             with ringbufblk_consume(). If the elements wrap around
+ *             the end of the array, only those before the end are
+ *             counted; the rest are found by peeking again after
+ *             consuming them.
+ */
+ringbufblk_index_t ringbufblk_peek(struct ringbufblk *r, void **elems);
+
+/**
+ * \brief      Remove elements from a block ring buffer
+ * \param r    A pointer to a struct ringbufblk
+ * \param num  The number of elements, at most as many as ringbufblk_peek() returned
+ */
+void ringbufblk_consume(struct ringbufblk *r, ringbufblk_index_t num);
+
+/**
+ * \brief      Get the free space that can be written in place
+ * \param r    A pointer to a struct ringbufblk
+ * \param elems Set to point to the first free element
+ * \return     The number of free elements, one after another, from
+ *             *elems on
+ *
+ *             The elements written there are added to the buffer
+ *             with ringbufblk_commit().
+ */
+ringbufblk_index_t ringbufblk_reserve(struct ringbufblk *r, void **elems);
+
+/**
+ * \brief      Add elements written in place to a block ring buffer
+ * \param r    A pointer to a struct ringbufblk
+ * \param num  The number of elements, at most as many as ringbufblk_reserve() returned
+ */
+void ringbufblk_commit(struct ringbufblk *r, ringbufblk_index_t num);
+
+/**
+ * \brief      Get the number of elements in a block ring buffer
+ * \param r    A pointer to a struct ringbufblk
+ * \return     The number of elements in the buffer
+ */
+ringbufblk_index_t ringbufblk_elements(struct ringbufblk *r);
+
+/**
+ * \brief      Get the number of free elements in a block ring buffer
+ * \param r    A pointer to a struct ringbufblk
+ * \return     The number of elements that can be put
+ */
+ringbufblk_index_t ringbufblk_space(struct ringbufblk *r);
+
+#endif /* __RINGBUFBLK_H__ */
+
+/** @}*/
+/** @}*/
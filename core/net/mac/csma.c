@@ -77,6 +77,18 @@
 #error Change CSMA_CONF_MAX_MAC_TRANSMISSIONS in contiki-conf.h or in your Makefile.
 #endif /* CSMA_CONF_MAX_MAC_TRANSMISSIONS < 1 */
 
+/* Send the next packet of a neighbor's queue as soon as the previous
+   one has been sent, instead of after a channel check interval. The
+   queue is handed to the RDC layer as a list, and RDCs that send it as
+   a burst (e.g. the Launchpad's WOR-RDC) keep the receiver awake
+   between the packets, so a bulk transfer goes out in one rendezvous.
+   Only enable this with such an RDC. */
+#ifdef CSMA_CONF_BURST
+#define CSMA_BURST CSMA_CONF_BURST
+#else
+#define CSMA_BURST 0
+#endif /* CSMA_CONF_BURST */
+
 /* Packet metadata */
 struct qbuf_metadata {
   mac_callback_t sent;
@@ -156,7 +168,7 @@ transmit_packet_list(void *ptr)
 }
 /*---------------------------------------------------------------------------*/
 static void
-free_first_packet(struct neighbor_queue *n)
+free_first_packet(struct neighbor_queue *n, clock_time_t time)
 {
   struct rdc_buf_list *q = list_head(n->queued_packet_list);
   if(q != NULL) {
@@ -173,7 +185,7 @@ free_first_packet(struct neighbor_queue *n)
       n->collisions = 0;
       n->deferrals = 0;
       /* Set a timer for next transmissions */
-      ctimer_set(&n->transmit_timer, default_timebase(), transmit_packet_list, n);
+      ctimer_set(&n->transmit_timer, time, transmit_packet_list, n);
     } else {
       /* This was the last packet in the queue, we free the neighbor */
       ctimer_stop(&n->transmit_timer);
@@ -257,7 +269,7 @@ packet_sent(void *ptr, int status, int num_transmissions)
     } else {
       PRINTF("csma: drop with status %d after %d transmissions, %d collisions\n",
              status, n->transmissions, n->collisions);
-      free_first_packet(n);
+      free_first_packet(n, default_timebase());
       mac_call_sent_callback(sent, cptr, status, num_tx);
     }
   } else {
@@ -266,7 +278,13 @@ packet_sent(void *ptr, int status, int num_transmissions)
     } else {
       PRINTF("csma: rexmit failed %d: %d\n", n->transmissions, status);
     }
-    free_first_packet(n);
+    time = default_timebase();
+#if CSMA_BURST
+    if(status == MAC_TX_OK) {
+      time = 0;
+    }
+#endif /* CSMA_BURST */
+    free_first_packet(n, time);
     mac_call_sent_callback(sent, cptr, status, num_tx);
   }
 }
@@ -310,7 +328,7 @@ send_packet(mac_callback_t sent, void *ptr)
       if(q != NULL) {
         q->ptr = memb_alloc(&metadata_memb);
         if(q->ptr != NULL) {
-          q->buf = queuebuf_new_from_packetbuf();
+          q->buf = queuebuf_share_from_packetbuf();
           if(q->buf != NULL) {
             struct qbuf_metadata *metadata = (struct qbuf_metadata *)q->ptr;
             /* Neighbor and packet successfully allocated */
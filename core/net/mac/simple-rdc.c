@@ -242,8 +242,9 @@ Ie, time to receive a packet, copy ACK->fifo, send ACK, would be < 0.30 ms, but
  * Set to 0 if radio handles ACKs, or if you are unsure. It will work, but be
  * less efficient.
  * 
- * Note that for CC2500, you enable radio layer ACKs by setting 
- *    USE_HW_ADDRESS_FILTER             1
+ * Note that the CC2500 driver does not ACK; its address filtering
+ * (CC2500_CONF_ADDRESS_FILTER) only keeps frames to other nodes out of the
+ * RxFIFO. The CC2500 WOR-RDC sends its own ACKs, see WORRDC_CONF_ACK_UNICAST.
  * 
  * On CC2420, radio HW ACKs are supported if packet is framed as an 802.15.4
  * hence in contiki-conf.h:
@@ -65,6 +65,9 @@ static uint8_t *packetbuf = (uint8_t *)packetbuf_aligned;
 
 static uint8_t *packetbufptr;
 
+/* The queued buffer that the data portion is known to be a copy of. */
+static const void *data_owner;
+
 #define DEBUG 0
 #if DEBUG
 #include <stdio.h>
@@ -81,6 +84,7 @@ packetbuf_clear(void)
   hdrptr = PACKETBUF_HDR_SIZE;
 
   packetbufptr = &packetbuf[PACKETBUF_HDR_SIZE];
+  data_owner = NULL;
   packetbuf_attr_clear();
 }
 /*---------------------------------------------------------------------------*/
@@ -111,6 +115,7 @@ packetbuf_compact(void)
     memcpy(&packetbuf[PACKETBUF_HDR_SIZE], packetbuf_reference_ptr(),
 	   packetbuf_datalen());
   } else if (bufptr > 0) {
+    data_owner = NULL;
     len = packetbuf_datalen() + PACKETBUF_HDR_SIZE;
     for(i = PACKETBUF_HDR_SIZE; i < len; i++) {
       packetbuf[i] = packetbuf[bufptr + i];
@@ -194,6 +199,7 @@ packetbuf_hdrreduce(int size)
 
   bufptr += size;
   buflen -= size;
+  data_owner = NULL;
   return 1;
 }
 /*---------------------------------------------------------------------------*/
@@ -202,11 +208,13 @@ packetbuf_set_datalen(uint16_t len)
 {
   PRINTF("packetbuf_set_len: len %d\n", len);
   buflen = len;
+  data_owner = NULL;
 }
 /*---------------------------------------------------------------------------*/
 void *
 packetbuf_dataptr(void)
 {
+  data_owner = NULL;
   return (void *)(&packetbuf[bufptr + PACKETBUF_HDR_SIZE]);
 }
 /*---------------------------------------------------------------------------*/
@@ -217,6 +225,18 @@ packetbuf_hdrptr(void)
 }
 /*---------------------------------------------------------------------------*/
 void
+packetbuf_set_data_owner(const void *owner)
+{
+  data_owner = owner;
+}
+/*---------------------------------------------------------------------------*/
+const void *
+packetbuf_data_owner(void)
+{
+  return data_owner;
+}
+/*---------------------------------------------------------------------------*/
+void
 packetbuf_reference(void *ptr, uint16_t len)
 {
   packetbuf_clear();
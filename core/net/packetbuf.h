@@ -314,6 +314,28 @@ int packetbuf_hdralloc(int size);
  */
 int packetbuf_hdrreduce(int size);
 
+/**
+ * \brief      Tag the data portion of the packetbuf with its origin
+ * \param owner An opaque pointer to the buffer that holds the same data, or NULL
+ *
+ *             This function is used by the queuebuf module to record
+ *             that the data portion of the packetbuf is a byte-for-byte
+ *             copy of a queued buffer. The tag is removed by every
+ *             function that may change the data portion, including
+ *             packetbuf_dataptr(), which hands out a writable
+ *             pointer. Extending the header with packetbuf_hdralloc()
+ *             keeps the tag.
+ *
+ */
+void packetbuf_set_data_owner(const void *owner);
+
+/**
+ * \brief      Get the origin of the data portion of the packetbuf
+ * \return     The tag set with packetbuf_set_data_owner(), or NULL
+ *
+ */
+const void *packetbuf_data_owner(void);
+
 /* Packet attributes stuff below: */
 
 typedef uint16_t packetbuf_attr_t;
@@ -49,7 +49,7 @@
 void
 packetqueue_init(struct packetqueue *q)
 {
-  list_init(*q->list);
+  list_tail_init(*q->list);
   memb_init(q->memb);
 }
 /*---------------------------------------------------------------------------*/
@@ -59,7 +59,7 @@ remove_queued_packet(void *item)
   struct packetqueue_item *i = item;
   struct packetqueue *q = i->queue;
 
-  list_remove(*q->list, i);
+  list_tail_remove(*q->list, i);
   queuebuf_free(i->buf);
   ctimer_stop(&i->lifetimer);
   memb_free(q->memb, i);
@@ -98,7 +98,7 @@ packetqueue_enqueue_packetbuf(struct packetqueue *q, clock_time_t lifetime,
   }
 
   /* Add the item to the queue. */
-  list_add(*q->list, i);
+  list_tail_add(*q->list, i);
 
   return 1;
 }
@@ -116,7 +116,7 @@ packetqueue_dequeue(struct packetqueue *q)
   
   i = list_head(*q->list);
   if(i != NULL) {
-    list_remove(*q->list, i);
+    list_tail_pop(*q->list);
     queuebuf_free(i->buf);
     ctimer_stop(&i->lifetimer);
     memb_free(q->memb, i);
@@ -102,7 +102,7 @@ struct packetqueue_item {
  *             is defined on a per-module basis.
  *
  */
-#define PACKETQUEUE(name, size) LIST(name##_list); \
+#define PACKETQUEUE(name, size) LIST_TAIL(name##_list); \
                                 MEMB(name##_memb, struct packetqueue_item, size); \
 				static struct packetqueue name = { &name##_list, \
 								   &name##_memb }
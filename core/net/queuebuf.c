@@ -65,6 +65,7 @@ struct queuebuf {
   int line;
   clock_time_t time;
 #endif /* QUEUEBUF_DEBUG */
+  uint8_t refs;
 #if WITH_SWAP
   enum {IN_RAM, IN_CFS} location;
   union {
@@ -84,15 +85,23 @@ struct queuebuf_data {
   struct packetbuf_addr addrs[PACKETBUF_NUM_ADDRS];
 };
 
-struct queuebuf_ref {
+/* A queuebuf that keeps its own header but points to data stored
+   elsewhere: either external data referenced with
+   packetbuf_reference(), or the data of another queuebuf (the owner),
+   on which it then holds a reference. */
+struct queuebuf_refbuf {
   uint16_t len;
   uint8_t *ref;
+  struct queuebuf *owner;
+  uint8_t refs;
   uint8_t hdr[PACKETBUF_HDR_SIZE];
   uint8_t hdrlen;
+  struct packetbuf_attr attrs[PACKETBUF_NUM_ATTRS];
+  struct packetbuf_addr addrs[PACKETBUF_NUM_ADDRS];
 };
 
 MEMB(bufmem, struct queuebuf, QUEUEBUF_NUM);
-MEMB(refbufmem, struct queuebuf_ref, QUEUEBUF_REF_NUM);
+MEMB(refbufmem, struct queuebuf_refbuf, QUEUEBUF_REF_NUM);
 MEMB(buframmem, struct queuebuf_data, QUEUEBUFRAM_NUM);
 
 #if WITH_SWAP
@@ -290,6 +299,40 @@ queuebuf_load_to_ram(struct queuebuf *b)
 }
 #endif /* WITH_SWAP */
 /*---------------------------------------------------------------------------*/
+static struct queuebuf_refbuf *
+as_refbuf(struct queuebuf *b)
+{
+  if(memb_inmemb(&refbufmem, b)) {
+    return (struct queuebuf_refbuf *)b;
+  }
+  return NULL;
+}
+/*---------------------------------------------------------------------------*/
+static struct queuebuf_refbuf *
+refbuf_new_from_packetbuf(uint8_t *ref, struct queuebuf *owner)
+{
+  struct queuebuf_refbuf *rbuf;
+
+  rbuf = memb_alloc(&refbufmem);
+  if(rbuf == NULL) {
+    PRINTF("queuebuf_new_from_packetbuf: could not allocate a reference queuebuf\n");
+    return NULL;
+  }
+#if QUEUEBUF_STATS
+  ++queuebuf_ref_len;
+#endif /* QUEUEBUF_STATS */
+  rbuf->refs = 1;
+  rbuf->len = packetbuf_datalen();
+  rbuf->ref = ref;
+  rbuf->owner = owner;
+  if(owner != NULL) {
+    queuebuf_ref(owner);
+  }
+  rbuf->hdrlen = packetbuf_copyto_hdr(rbuf->hdr);
+  packetbuf_attr_copyto(rbuf->attrs, rbuf->addrs);
+  return rbuf;
+}
+/*---------------------------------------------------------------------------*/
 void
 queuebuf_init(void)
 {
@@ -317,25 +360,15 @@ queuebuf_new_from_packetbuf(void)
 #endif /* QUEUEBUF_DEBUG */
 {
   struct queuebuf *buf;
-  struct queuebuf_ref *rbuf;
 
   if(packetbuf_is_reference()) {
-    rbuf = memb_alloc(&refbufmem);
-    if(rbuf != NULL) {
-#if QUEUEBUF_STATS
-      ++queuebuf_ref_len;
-#endif /* QUEUEBUF_STATS */
-      rbuf->len = packetbuf_datalen();
-      rbuf->ref = packetbuf_reference_ptr();
-      rbuf->hdrlen = packetbuf_copyto_hdr(rbuf->hdr);
-    } else {
-      PRINTF("queuebuf_new_from_packetbuf: could not allocate a reference queuebuf\n");
-    }
-    return (struct queuebuf *)rbuf;
+    return (struct queuebuf *)
+      refbuf_new_from_packetbuf(packetbuf_reference_ptr(), NULL);
   } else {
     struct queuebuf_data *buframptr;
     buf = memb_alloc(&bufmem);
     if(buf != NULL) {
+      buf->refs = 1;
 #if QUEUEBUF_DEBUG
       list_add(queuebuf_list, buf);
       buf->file = file;
@@ -386,6 +419,16 @@ queuebuf_new_from_packetbuf(void)
       }
 #endif /* QUEUEBUF_STATS */
 
+      /* Without any header, the data in the packetbuf is now an
+         exact copy of the data in the queuebuf. */
+#if WITH_SWAP
+      if(buf->location == IN_RAM && packetbuf_hdrlen() == 0) {
+#else
+      if(packetbuf_hdrlen() == 0) {
+#endif
+        packetbuf_set_data_owner(buf);
+      }
+
     } else {
       PRINTF("queuebuf_new_from_packetbuf: could not allocate a queuebuf\n");
     }
@@ -393,10 +436,47 @@ queuebuf_new_from_packetbuf(void)
   }
 }
 /*---------------------------------------------------------------------------*/
+#if QUEUEBUF_DEBUG
+struct queuebuf *
+queuebuf_share_from_packetbuf_debug(const char *file, int line)
+#else /* QUEUEBUF_DEBUG */
+struct queuebuf *
+queuebuf_share_from_packetbuf(void)
+#endif /* QUEUEBUF_DEBUG */
+{
+  struct queuebuf_refbuf *rbuf;
+  struct queuebuf *owner;
+
+  /* If the data in the packetbuf is still a copy of a queuebuf in
+     RAM, typically because a Rime module has just placed one of its
+     queued packets into the packetbuf and only added headers to it,
+     we share the data of that queuebuf instead of copying it. If no
+     reference queuebuf is available, we fall back to a copy. */
+  owner = (struct queuebuf *)packetbuf_data_owner();
+  if(owner != NULL && !packetbuf_is_reference()) {
+    rbuf = refbuf_new_from_packetbuf(owner->ram_ptr->data, owner);
+    if(rbuf != NULL) {
+      return (struct queuebuf *)rbuf;
+    }
+  }
+#if QUEUEBUF_DEBUG
+  return queuebuf_new_from_packetbuf_debug(file, line);
+#else /* QUEUEBUF_DEBUG */
+  return queuebuf_new_from_packetbuf();
+#endif /* QUEUEBUF_DEBUG */
+}
+/*---------------------------------------------------------------------------*/
 void
 queuebuf_update_attr_from_packetbuf(struct queuebuf *buf)
 {
-  struct queuebuf_data *buframptr = queuebuf_load_to_ram(buf);
+  struct queuebuf_refbuf *r = as_refbuf(buf);
+  struct queuebuf_data *buframptr;
+
+  if(r != NULL) {
+    packetbuf_attr_copyto(r->attrs, r->addrs);
+    return;
+  }
+  buframptr = queuebuf_load_to_ram(buf);
   packetbuf_attr_copyto(buframptr->attrs, buframptr->addrs);
 #if WITH_SWAP
   if(buf->location == IN_CFS) {
@@ -405,10 +485,56 @@ queuebuf_update_attr_from_packetbuf(struct queuebuf *buf)
 #endif
 }
 /*---------------------------------------------------------------------------*/
+int
+queuebuf_write(struct queuebuf *b, uint16_t offset,
+               const void *data, uint16_t len)
+{
+  struct queuebuf_data *buframptr;
+
+  if(!memb_inmemb(&bufmem, b) || b->refs > 1) {
+    return 0;
+  }
+  buframptr = queuebuf_load_to_ram(b);
+  if(offset + len > buframptr->len) {
+    return 0;
+  }
+  memcpy(&buframptr->data[offset], data, len);
+#if WITH_SWAP
+  if(b->location == IN_CFS) {
+    queuebuf_flush_tmpdata();
+  }
+#endif
+  if(packetbuf_data_owner() == b) {
+    packetbuf_set_data_owner(NULL);
+  }
+  return 1;
+}
+/*---------------------------------------------------------------------------*/
+struct queuebuf *
+queuebuf_ref(struct queuebuf *b)
+{
+  struct queuebuf_refbuf *r = as_refbuf(b);
+
+  if(r != NULL) {
+    ++r->refs;
+  } else if(memb_inmemb(&bufmem, b)) {
+    ++b->refs;
+  }
+  return b;
+}
+/*---------------------------------------------------------------------------*/
 void
 queuebuf_free(struct queuebuf *buf)
 {
+  struct queuebuf_refbuf *r;
+
   if(memb_inmemb(&bufmem, buf)) {
+    if(--buf->refs > 0) {
+      return;
+    }
+    if(packetbuf_data_owner() == buf) {
+      packetbuf_set_data_owner(NULL);
+    }
 #if WITH_SWAP
     if(buf->location == IN_RAM) {
       memb_free(&buframmem, buf->ram_ptr);
@@ -427,7 +553,14 @@ queuebuf_free(struct queuebuf *buf)
     list_remove(queuebuf_list, buf);
 #endif /* QUEUEBUF_DEBUG */
   } else if(memb_inmemb(&refbufmem, buf)) {
-    memb_free(&refbufmem, buf);
+    r = (struct queuebuf_refbuf *)buf;
+    if(--r->refs > 0) {
+      return;
+    }
+    if(r->owner != NULL) {
+      queuebuf_free(r->owner);
+    }
+    memb_free(&refbufmem, r);
 #if QUEUEBUF_STATS
     --queuebuf_ref_len;
 #endif /* QUEUEBUF_STATS */
@@ -437,30 +570,38 @@ queuebuf_free(struct queuebuf *buf)
 void
 queuebuf_to_packetbuf(struct queuebuf *b)
 {
-  struct queuebuf_ref *r;
+  struct queuebuf_refbuf *r;
   if(memb_inmemb(&bufmem, b)) {
     struct queuebuf_data *buframptr = queuebuf_load_to_ram(b);
     packetbuf_copyfrom(buframptr->data, buframptr->len);
     packetbuf_attr_copyfrom(buframptr->attrs, buframptr->addrs);
+#if WITH_SWAP
+    if(b->location == IN_RAM) {
+      packetbuf_set_data_owner(b);
+    }
+#else
+    packetbuf_set_data_owner(b);
+#endif
   } else if(memb_inmemb(&refbufmem, b)) {
-    r = (struct queuebuf_ref *)b;
-    packetbuf_clear();
+    r = (struct queuebuf_refbuf *)b;
     packetbuf_copyfrom(r->ref, r->len);
     packetbuf_hdralloc(r->hdrlen);
     memcpy(packetbuf_hdrptr(), r->hdr, r->hdrlen);
+    packetbuf_attr_copyfrom(r->attrs, r->addrs);
+    packetbuf_set_data_owner(r->owner);
   }
 }
 /*---------------------------------------------------------------------------*/
 void *
 queuebuf_dataptr(struct queuebuf *b)
 {
-  struct queuebuf_ref *r;
+  struct queuebuf_refbuf *r;
 
   if(memb_inmemb(&bufmem, b)) {
     struct queuebuf_data *buframptr = queuebuf_load_to_ram(b);
     return buframptr->data;
   } else if(memb_inmemb(&refbufmem, b)) {
-    r = (struct queuebuf_ref *)b;
+    r = (struct queuebuf_refbuf *)b;
     return r->ref;
   }
   return NULL;
@@ -469,21 +610,39 @@ queuebuf_dataptr(struct queuebuf *b)
 int
 queuebuf_datalen(struct queuebuf *b)
 {
-  struct queuebuf_data *buframptr = queuebuf_load_to_ram(b);
+  struct queuebuf_refbuf *r = as_refbuf(b);
+  struct queuebuf_data *buframptr;
+
+  if(r != NULL) {
+    return r->len;
+  }
+  buframptr = queuebuf_load_to_ram(b);
   return buframptr->len;
 }
 /*---------------------------------------------------------------------------*/
 rimeaddr_t *
 queuebuf_addr(struct queuebuf *b, uint8_t type)
 {
-  struct queuebuf_data *buframptr = queuebuf_load_to_ram(b);
+  struct queuebuf_refbuf *r = as_refbuf(b);
+  struct queuebuf_data *buframptr;
+
+  if(r != NULL) {
+    return &r->addrs[type - PACKETBUF_ADDR_FIRST].addr;
+  }
+  buframptr = queuebuf_load_to_ram(b);
   return &buframptr->addrs[type - PACKETBUF_ADDR_FIRST].addr;
 }
 /*---------------------------------------------------------------------------*/
 packetbuf_attr_t
 queuebuf_attr(struct queuebuf *b, uint8_t type)
 {
-  struct queuebuf_data *buframptr = queuebuf_load_to_ram(b);
+  struct queuebuf_refbuf *r = as_refbuf(b);
+  struct queuebuf_data *buframptr;
+
+  if(r != NULL) {
+    return r->attrs[type].val;
+  }
+  buframptr = queuebuf_load_to_ram(b);
   return buframptr->attrs[type].val;
 }
 /*---------------------------------------------------------------------------*/
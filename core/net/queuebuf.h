@@ -93,13 +93,33 @@ void queuebuf_init(void);
 #if QUEUEBUF_DEBUG
 struct queuebuf *queuebuf_new_from_packetbuf_debug(const char *file, int line);
 #define queuebuf_new_from_packetbuf() queuebuf_new_from_packetbuf_debug(__FILE__, __LINE__)
+struct queuebuf *queuebuf_share_from_packetbuf_debug(const char *file, int line);
+#define queuebuf_share_from_packetbuf() queuebuf_share_from_packetbuf_debug(__FILE__, __LINE__)
 #else /* QUEUEBUF_DEBUG */
 struct queuebuf *queuebuf_new_from_packetbuf(void);
+struct queuebuf *queuebuf_share_from_packetbuf(void);
 #endif /* QUEUEBUF_DEBUG */
 void queuebuf_update_attr_from_packetbuf(struct queuebuf *b);
 
 void queuebuf_to_packetbuf(struct queuebuf *b);
+
+/* Queuebufs are reference counted. queuebuf_ref() adds a reference
+   and returns the queuebuf, queuebuf_free() drops one and releases
+   the buffer when the last reference is gone.
+
+   queuebuf_share_from_packetbuf() works like
+   queuebuf_new_from_packetbuf(), but if the packetbuf still holds the
+   unmodified data of another queuebuf, it shares that data instead of
+   copying it and keeps only the header. queuebuf_dataptr() and
+   queuebuf_datalen() of such a queuebuf cover the data without the
+   header, so it must be put back with queuebuf_to_packetbuf() before
+   it is sent. The data of a queuebuf must not be modified in place,
+   except through queuebuf_write(), which refuses to touch shared
+   data. */
+struct queuebuf *queuebuf_ref(struct queuebuf *b);
 void queuebuf_free(struct queuebuf *b);
+int queuebuf_write(struct queuebuf *b, uint16_t offset,
+                   const void *data, uint16_t len);
 
 void *queuebuf_dataptr(struct queuebuf *b);
 int queuebuf_datalen(struct queuebuf *b);
@@ -98,8 +98,8 @@ periodic(void *ptr)
       n->le_age = 0;
     }
     if(n->age == MAX_AGE) {
-      memb_free(&collect_neighbors_mem, n);
       list_remove(neighbor_list->list, n);
+      memb_free(&collect_neighbors_mem, n);
       n = list_head(neighbor_list->list);
     }
   }
@@ -556,6 +556,7 @@ send_queued_packet(struct collect_conn *c)
   struct packetqueue_item *i;
   struct data_msg_hdr hdr;
   int max_mac_rexmits;
+  int hdr_in_queuebuf;
 
   /* If we are currently sending a packet, we do not attempt to send
      another one. */
@@ -578,6 +579,14 @@ send_queued_packet(struct collect_conn *c)
   /* We should send the first packet from the queue. */
   q = packetqueue_queuebuf(i);
   if(q != NULL) {
+    /* Copy our rtmetric into the packet header of the queued packet
+       before placing it into the packetbuf, so that the MAC layer
+       can share the payload with our send queue instead of copying
+       it. */
+    memset(&hdr, 0, sizeof(hdr));
+    hdr.rtmetric = c->rtmetric;
+    hdr_in_queuebuf = queuebuf_write(q, 0, &hdr, sizeof(struct data_msg_hdr));
+
     /* Place the queued packet into the packetbuf. */
     queuebuf_to_packetbuf(q);
 
@@ -624,11 +633,11 @@ send_queued_packet(struct collect_conn *c)
 
       stats.datasent++;
 
-      /* Copy our rtmetric into the packet header of the outgoing
-         packet. */
-      memset(&hdr, 0, sizeof(hdr));
-      hdr.rtmetric = c->rtmetric;
-      memcpy(packetbuf_dataptr(), &hdr, sizeof(struct data_msg_hdr));
+      /* If the queued packet could not be updated, copy our rtmetric
+         into the packet header of the outgoing packet instead. */
+      if(!hdr_in_queuebuf) {
+        memcpy(packetbuf_dataptr(), &hdr, sizeof(struct data_msg_hdr));
+      }
 
       /* Send the packet. */
       send_packet(c, n);
@@ -662,6 +671,7 @@ retransmit_current_packet(struct collect_conn *c)
   struct packetqueue_item *i;
   struct data_msg_hdr hdr;
   int max_mac_rexmits;
+  int hdr_in_queuebuf;
 
   /* Grab the first packet on the send queue, which is the one we are
      about to retransmit. */
@@ -678,6 +688,12 @@ retransmit_current_packet(struct collect_conn *c)
   if(q != NULL) {
 
     update_rtmetric(c);
+
+    /* Copy our rtmetric into the packet header of the queued packet,
+       as in send_queued_packet(). */
+    memset(&hdr, 0, sizeof(hdr));
+    hdr.rtmetric = c->rtmetric;
+    hdr_in_queuebuf = queuebuf_write(q, 0, &hdr, sizeof(struct data_msg_hdr));
     
     /* Place the queued packet into the packetbuf. */
     queuebuf_to_packetbuf(q);
@@ -723,11 +739,11 @@ retransmit_current_packet(struct collect_conn *c)
       packetbuf_set_attr(PACKETBUF_ATTR_MAX_MAC_TRANSMISSIONS, max_mac_rexmits);
       packetbuf_set_attr(PACKETBUF_ATTR_PACKET_ID, c->seqno);
 
-      /* Copy our rtmetric into the packet header of the outgoing
-         packet. */
-      memset(&hdr, 0, sizeof(hdr));
-      hdr.rtmetric = c->rtmetric;
-      memcpy(packetbuf_dataptr(), &hdr, sizeof(struct data_msg_hdr));
+      /* If the queued packet could not be updated, copy our rtmetric
+         into the packet header of the outgoing packet instead. */
+      if(!hdr_in_queuebuf) {
+        memcpy(packetbuf_dataptr(), &hdr, sizeof(struct data_msg_hdr));
+      }
 
       /* Send the packet. */
       send_packet(c, n);
@@ -1279,7 +1295,7 @@ collect_open(struct collect_conn *tc, uint16_t channels,
   tc->is_router = is_router;
   tc->seqno = 10;
   tc->eseqno = 0;
-  LIST_STRUCT_INIT(tc, send_queue_list);
+  LIST_TAIL_STRUCT_INIT(tc, send_queue_list);
   collect_neighbor_list_new(&tc->neighbor_list);
   tc->send_queue.list = &(tc->send_queue_list);
   tc->send_queue.memb = &send_queue_memb;
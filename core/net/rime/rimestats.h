@@ -54,12 +54,32 @@ struct rimestats {
     sendingdrop; /* Packet dropped when we were sending a packet */
 
   unsigned long lltx, llrx;
+
+  /* Radio driver receive path: */
+  unsigned long llrxoverflow, /* Receive FIFO overflows */
+    llrxpolls, /* Wakeups of the driver that read at least one packet */
+    llrxburst; /* Most packets read in one wakeup */
 };
 
 extern struct rimestats rimestats;
 
-/* this removes the entire use of rimestats, saving 72 precious bytes */
+/* Off by default: the counters take 84 precious bytes of RAM. */
+#ifdef RIMESTATS_CONF_ENABLED
+#define RIMESTATS_ENABLED RIMESTATS_CONF_ENABLED
+#else
+#define RIMESTATS_ENABLED 0
+#endif
+
+#if RIMESTATS_ENABLED
+#define RIMESTATS_ADD(x) rimestats.x++
+#define RIMESTATS_MAX(x, y) do {                        \
+    if((y) > rimestats.x) {                             \
+      rimestats.x = (y);                                \
+    }                                                   \
+  } while(0)
+#else /* RIMESTATS_ENABLED */
 #define RIMESTATS_ADD(x)
-//#define RIMESTATS_ADD(x) rimestats.x++
+#define RIMESTATS_MAX(x, y)
+#endif /* RIMESTATS_ENABLED */
 
 #endif /* __RIMESTATS_H__ */
@@ -92,9 +92,10 @@ static int max_time = DEFAULT_LIFETIME;
 static void
 periodic(void *ptr)
 {
-  struct route_entry *e;
+  struct route_entry *e, *next;
 
-  for(e = list_head(route_table); e != NULL; e = list_item_next(e)) {
+  for(e = list_head(route_table); e != NULL; e = next) {
+    next = list_item_next(e);
     e->time++;
     if(e->time >= max_time) {
       PRINTF("route periodic: removing entry to %d.%d with nexthop %d.%d and cost %d\n",
@@ -0,0 +1,208 @@
+/*
+ * Copyright (c) 2013, Swedish Institute of Computer Science.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the Institute nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE INSTITUTE AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE INSTITUTE OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ *
+ * This file is part of the Contiki operating system.
+ */
+
+/**
+ * \file
+ *         uIP checksum helpers
+ */
+
+#include "net/uip-chksum.h"
+
+#include <string.h>
+
+#if UIP_WIDE_CHKSUM
+/*---------------------------------------------------------------------------*/
+/* One's complement sum of the buffer, read as 32-bit words in host
+   byte order. The buffer must be aligned on a 4-byte boundary. */
+static uint16_t
+sum_words(const uint8_t *data, uint16_t len)
+{
+  uint32_t acc, w;
+  uint16_t h;
+
+  acc = 0;
+  for(; len >= 16; len -= 16, data += 16) {
+    memcpy(&w, data, 4);
+    acc += w;
+    if(acc < w) {
+      acc++;
+    }
+    memcpy(&w, data + 4, 4);
+    acc += w;
+    if(acc < w) {
+      acc++;
+    }
+    memcpy(&w, data + 8, 4);
+    acc += w;
+    if(acc < w) {
+      acc++;
+    }
+    memcpy(&w, data + 12, 4);
+    acc += w;
+    if(acc < w) {
+      acc++;
+    }
+  }
+  for(; len >= 4; len -= 4, data += 4) {
+    memcpy(&w, data, 4);
+    acc += w;
+    if(acc < w) {
+      acc++;
+    }
+  }
+
+  /* Fold the accumulator, so that the remaining bytes can be added
+     without overflowing it. */
+  acc = (acc >> 16) + (acc & 0xffff);
+
+  /* Add the remaining bytes; a last odd byte is padded with a zero. */
+  if(len >= 2) {
+    memcpy(&h, data, 2);
+    acc += h;
+    data += 2;
+    len -= 2;
+  }
+  if(len == 1) {
+    uint8_t last[2];
+    last[0] = *data;
+    last[1] = 0;
+    memcpy(&h, last, 2);
+    acc += h;
+  }
+  acc = (acc >> 16) + (acc & 0xffff);
+  acc += acc >> 16;
+  return (uint16_t)acc;
+}
+#endif /* UIP_WIDE_CHKSUM */
+/*---------------------------------------------------------------------------*/
+uint16_t
+uip_chksum_add(uint16_t sum, const uint8_t *data, uint16_t len)
+{
+#if UIP_WIDE_CHKSUM
+  uint16_t t;
+  uint8_t odd;
+  uint16_t head;
+
+  /* Consume bytes until the buffer is aligned. An odd address means
+     that the rest of the buffer is paired one byte off, which the
+     one's complement sum compensates for by swapping its bytes. */
+  odd = 0;
+  head = 0;
+  if(len > 0 && ((size_t)data & 1)) {
+    head = *data << 8;
+    odd = 1;
+    data++;
+    len--;
+  }
+  if(len >= 2 && ((size_t)data & 2)) {
+    t = (data[0] << 8) + data[1];
+    if(odd) {
+      t = (t >> 8) | (t << 8);
+    }
+    head += t;
+    if(head < t) {
+      head++;
+    }
+    data += 2;
+    len -= 2;
+  }
+
+  t = sum_words(data, len);
+  t = uip_ntohs(t);
+  if(odd) {
+    t = (t >> 8) | (t << 8);
+  }
+
+  sum += head;
+  if(sum < head) {
+    sum++;
+  }
+  sum += t;
+  if(sum < t) {
+    sum++;
+  }
+  return sum;
+#else /* UIP_WIDE_CHKSUM */
+  uint16_t t;
+  const uint8_t *dataptr;
+  const uint8_t *last_byte;
+
+  dataptr = data;
+  last_byte = data + len - 1;
+
+  while(dataptr < last_byte) {	/* At least two more bytes */
+    t = (dataptr[0] << 8) + dataptr[1];
+    sum += t;
+    if(sum < t) {
+      sum++;		/* carry */
+    }
+    dataptr += 2;
+  }
+
+  if(dataptr == last_byte) {
+    t = (dataptr[0] << 8) + 0;
+    sum += t;
+    if(sum < t) {
+      sum++;		/* carry */
+    }
+  }
+
+  /* Return sum in host byte order. */
+  return sum;
+#endif /* UIP_WIDE_CHKSUM */
+}
+/*---------------------------------------------------------------------------*/
+uint16_t
+uip_chksum_adjust(uint16_t chksum, const void *from, const void *to,
+                  uint16_t len)
+{
+  const uint8_t *f = from;
+  const uint8_t *n = to;
+  uint16_t sum, t;
+
+  /* RFC 1624, eqn. 3: HC' = ~(~HC + ~m + m') */
+  sum = ~uip_ntohs(chksum);
+  for(; len >= 2; len -= 2, f += 2, n += 2) {
+    t = ~((f[0] << 8) + f[1]);
+    sum += t;
+    if(sum < t) {
+      sum++;
+    }
+    t = (n[0] << 8) + n[1];
+    sum += t;
+    if(sum < t) {
+      sum++;
+    }
+  }
+  return uip_htons(~sum);
+}
+/*---------------------------------------------------------------------------*/
+/** @} */
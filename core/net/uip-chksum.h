@@ -0,0 +1,93 @@
+/*
+ * Copyright (c) 2013, Swedish Institute of Computer Science.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the Institute nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE INSTITUTE AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE INSTITUTE OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ *
+ * This file is part of the Contiki operating system.
+ */
+
+/**
+ * \addtogroup uip
+ * @{
+ */
+
+/**
+ * \defgroup uipchksum uIP checksum helpers
+ * @{
+ *
+ * The uipchksum module computes the one's complement sums that the
+ * Internet checksums are built from, and updates a checksum in place
+ * when a few header fields are rewritten, as when forwarding a
+ * packet, without summing the whole packet again (RFC 1624).
+ *
+ * With UIP_CONF_WIDE_CHKSUM set, sums are accumulated 32 bits at a
+ * time, which is much faster on 32- and 64-bit CPUs.
+ */
+
+/**
+ * \file
+ *         Header file for the uIP checksum helpers
+ */
+
+#ifndef __UIP_CHKSUM_H__
+#define __UIP_CHKSUM_H__
+
+#include "net/uip.h"
+
+/**
+ * \brief      Add a buffer to a one's complement sum
+ * \param sum  The sum so far, in host byte order
+ * \param data A pointer to the buffer
+ * \param len  The length of the buffer
+ * \return     The new sum, in host byte order
+ *
+ *             The buffer is summed as a sequence of 16-bit words in
+ *             network byte order; an odd last byte is padded with a
+ *             zero. The buffer does not need to be aligned.
+ */
+uint16_t uip_chksum_add(uint16_t sum, const uint8_t *data, uint16_t len);
+
+/**
+ * \brief      Update a checksum after some of the data it covers changed
+ * \param chksum The checksum field, as stored in the packet
+ * \param from A pointer to a copy of the old data
+ * \param to   A pointer to the new data
+ * \param len  The length of the changed data, an even number of bytes
+ * \return     The new checksum field, to be stored in the packet
+ *
+ *             This function computes the checksum field that
+ *             covers the new data, from the old checksum field and
+ *             the old and new data alone (RFC 1624). The changed data
+ *             must start at an even offset from the start of the data
+ *             covered by the checksum.
+ */
+uint16_t uip_chksum_adjust(uint16_t chksum, const void *from, const void *to,
+                           uint16_t len);
+
+#endif /* __UIP_CHKSUM_H__ */
+
+/** @} */
+/** @} */
@@ -60,6 +60,7 @@
 #include "net/uip.h"
 #include "net/uip_arch.h"
 #include "net/uip-fw.h"
+#include "net/uip-chksum.h"
 #ifdef AODV_COMPLIANCE
 #include "net/uaodv-def.h"
 #endif
@@ -404,6 +405,7 @@ uint8_t
 uip_fw_forward(void)
 {
   struct fwcache_entry *fw;
+  uint16_t ttl_proto;
 
   /* First check if the packet is destined for ourselves and return 0
      to indicate that the packet should be processed locally. */
@@ -463,14 +465,11 @@ uip_fw_forward(void)
   }
   
   /* Decrement the TTL (time-to-live) value in the IP header */
+  memcpy(&ttl_proto, &BUF->ttl, 2);
   BUF->ttl = BUF->ttl - 1;
   
-  /* Update the IP checksum. */
-  if(BUF->ipchksum >= UIP_HTONS(0xffff - 0x0100)) {
-    BUF->ipchksum = BUF->ipchksum + UIP_HTONS(0x0100) + 1;
-  } else {
-    BUF->ipchksum = BUF->ipchksum + UIP_HTONS(0x0100);
-  }
+  /* Update the IP checksum for the changed TTL. */
+  BUF->ipchksum = uip_chksum_adjust(BUF->ipchksum, &ttl_proto, &BUF->ttl, 2);
 
   if(uip_len > 0) {
     uip_appdata = &uip_buf[UIP_LLH_LEN + UIP_TCPIP_HLEN];
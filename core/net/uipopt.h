@@ -618,6 +618,21 @@ void uip_log(char *msg);
 #define UIP_BYTE_ORDER     (UIP_LITTLE_ENDIAN)
 #endif /* UIP_CONF_BYTE_ORDER */
 
+/**
+ * Sum the Internet checksum 32 bits at a time.
+ *
+ * By default, the checksum is summed one 16-bit word at a time, which
+ * suits 8- and 16-bit CPUs. On 32- and 64-bit CPUs, summing 32-bit
+ * words is considerably faster.
+ *
+ * \hideinitializer
+ */
+#ifdef UIP_CONF_WIDE_CHKSUM
+#define UIP_WIDE_CHKSUM    (UIP_CONF_WIDE_CHKSUM)
+#else /* UIP_CONF_WIDE_CHKSUM */
+#define UIP_WIDE_CHKSUM    0
+#endif /* UIP_CONF_WIDE_CHKSUM */
+
 /** @} */
 /*------------------------------------------------------------------------------*/
 
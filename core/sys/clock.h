@@ -81,6 +81,18 @@
 #define CLOCK_SECOND (clock_time_t)32
 #endif
 
+/**
+ * Let the CPU sleep through clock ticks when nothing is due. The
+ * clock driver then programs its timer for the next etimer deadline
+ * before the CPU goes to sleep, and clock_time() and clock_seconds()
+ * account for the ticks that passed without an interrupt. Only
+ * drivers that implement clock_idle_enter() and clock_idle_exit()
+ * support this.
+ */
+#ifndef CLOCK_CONF_TICKLESS
+#define CLOCK_CONF_TICKLESS 0
+#endif /* CLOCK_CONF_TICKLESS */
+
 /**
  * Initialize the clock library.
  *
@@ -135,6 +147,23 @@ void clock_delay_usec(uint16_t dt);
  * Deprecated platform-specific routines.
  *
  */
+#if CLOCK_CONF_TICKLESS
+/**
+ * Stop the periodic clock tick until the next etimer deadline.
+ *
+ * Called by the main loop, with interrupts masked, right before it
+ * puts the CPU to sleep.
+ */
+void clock_idle_enter(void);
+
+/**
+ * Bring the clock up to date and restart the periodic tick.
+ *
+ * Called by the main loop when the CPU wakes up.
+ */
+void clock_idle_exit(void);
+#endif /* CLOCK_CONF_TICKLESS */
+
 int clock_fine_max(void);
 unsigned short clock_fine(void);
 void clock_delay(unsigned int delay);
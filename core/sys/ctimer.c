@@ -67,7 +67,7 @@ PROCESS_THREAD(ctimer_process, ev, data)
   PROCESS_BEGIN();
 
   for(c = list_head(ctimer_list); c != NULL; c = c->next) {
-    etimer_set(&c->etimer, c->etimer.timer.interval);
+    etimer_set_slack(&c->etimer, c->etimer.timer.interval, c->etimer.slack);
   }
   initialized = 1;
 
@@ -96,9 +96,22 @@ ctimer_init(void)
   process_start(&ctimer_process, NULL);
 }
 /*---------------------------------------------------------------------------*/
+#if ETIMER_CONF_SLACK
 void
 ctimer_set(struct ctimer *c, clock_time_t t,
 	   void (*f)(void *), void *ptr)
+{
+  ctimer_set_slack(c, t, 0, f, ptr);
+}
+/*---------------------------------------------------------------------------*/
+void
+ctimer_set_slack(struct ctimer *c, clock_time_t t, clock_time_t slack,
+		 void (*f)(void *), void *ptr)
+#else /* ETIMER_CONF_SLACK */
+void
+ctimer_set(struct ctimer *c, clock_time_t t,
+	   void (*f)(void *), void *ptr)
+#endif /* ETIMER_CONF_SLACK */
 {
   PRINTF("ctimer_set %p %u\n", c, (unsigned)t);
   c->p = PROCESS_CURRENT();
@@ -106,10 +119,13 @@ ctimer_set(struct ctimer *c, clock_time_t t,
   c->ptr = ptr;
   if(initialized) {
     PROCESS_CONTEXT_BEGIN(&ctimer_process);
-    etimer_set(&c->etimer, t);
+    etimer_set_slack(&c->etimer, t, slack);
     PROCESS_CONTEXT_END(&ctimer_process);
   } else {
     c->etimer.timer.interval = t;
+#if ETIMER_CONF_SLACK
+    c->etimer.slack = slack;
+#endif /* ETIMER_CONF_SLACK */
   }
 
   list_remove(ctimer_list, c);
@@ -114,6 +114,27 @@ void ctimer_restart(struct ctimer *c);
 void ctimer_set(struct ctimer *c, clock_time_t t,
 		void (*f)(void *), void *ptr);
 
+/**
+ * \brief      Set a callback timer that may fire late.
+ * \param c    A pointer to the callback timer.
+ * \param t    The interval before the timer expires.
+ * \param slack The number of ticks the timer may fire after the
+ *             interval has passed.
+ * \param f    A function to be called when the timer expires.
+ * \param ptr  An opaque pointer that will be supplied as an argument to the callback function.
+ *
+ *             This function works like ctimer_set(), but lets the
+ *             timer be handled together with other timers that expire
+ *             within the slack, see etimer_set_slack().
+ *
+ */
+#if ETIMER_CONF_SLACK
+void ctimer_set_slack(struct ctimer *c, clock_time_t t, clock_time_t slack,
+		      void (*f)(void *), void *ptr);
+#else /* ETIMER_CONF_SLACK */
+#define ctimer_set_slack(c, t, slack, f, ptr) ctimer_set(c, t, f, ptr)
+#endif /* ETIMER_CONF_SLACK */
+
 /**
  * \brief      Stop a pending callback timer.
  * \param c    A pointer to the pending callback timer.
@@ -39,6 +39,7 @@
  */
 
 #include "sys/energest.h"
+#include "sys/process.h"
 #include "contiki-conf.h"
 
 #if ENERGEST_CONF_ON
@@ -51,6 +52,12 @@ energest_t energest_leveldevice_current_leveltime[ENERGEST_CONF_LEVELDEVICE_LEVE
 #endif
 unsigned char energest_current_mode[ENERGEST_TYPE_MAX];
 
+#if ENERGEST_CONF_PROCESSES
+/* The process that CPU time is currently charged to, and since when. */
+static struct process *charged;
+static rtimer_clock_t charged_since;
+#endif /* ENERGEST_CONF_PROCESSES */
+
 /*---------------------------------------------------------------------------*/
 void
 energest_init(void)
@@ -114,9 +121,53 @@ energest_flush(void)
   }
 }
 /*---------------------------------------------------------------------------*/
+#if ENERGEST_CONF_PROCESSES
+static void
+charge(void)
+{
+  rtimer_clock_t now;
+
+  now = RTIMER_NOW();
+  if(charged != NULL) {
+    charged->energest_cpu += (rtimer_clock_t)(now - charged_since);
+  }
+  charged_since = now;
+}
+/*---------------------------------------------------------------------------*/
+struct process *
+energest_process_enter(struct process *p)
+{
+  struct process *caller;
+
+  charge();
+  caller = charged;
+  charged = p;
+  return caller;
+}
+/*---------------------------------------------------------------------------*/
+void
+energest_process_leave(struct process *caller)
+{
+  charge();
+  charged = caller;
+}
+/*---------------------------------------------------------------------------*/
+unsigned long
+energest_process_time(struct process *p)
+{
+  if(p == charged) {
+    charge();
+  }
+  return p->energest_cpu;
+}
+#else /* ENERGEST_CONF_PROCESSES */
+unsigned long energest_process_time(struct process *p) { return 0; }
+#endif /* ENERGEST_CONF_PROCESSES */
+/*---------------------------------------------------------------------------*/
 #else /* ENERGEST_CONF_ON */
 void energest_type_set(int type, unsigned long val) {}
 void energest_init(void) {}
 unsigned long energest_type_time(int type) { return 0; }
 void energest_flush(void) {}
+unsigned long energest_process_time(struct process *p) { return 0; }
 #endif /* ENERGEST_CONF_ON */
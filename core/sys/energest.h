@@ -68,6 +68,19 @@ enum energest_type {
   ENERGEST_TYPE_MAX
 };
 
+/**
+ * Also account the CPU time spent in each process, in the process
+ * structure. Time is charged to the process that is being called, so
+ * a process that calls another with process_post_synch() is not
+ * charged for the time the other one takes. Interrupts that arrive
+ * while a process runs are charged to that process.
+ */
+#ifndef ENERGEST_CONF_PROCESSES
+#define ENERGEST_CONF_PROCESSES 0
+#endif /* ENERGEST_CONF_PROCESSES */
+
+struct process;
+
 void energest_init(void);
 unsigned long energest_type_time(int type);
 #ifdef ENERGEST_CONF_LEVELDEVICE_LEVELS
@@ -75,6 +88,7 @@ unsigned long energest_leveldevice_leveltime(int powerlevel);
 #endif
 void energest_type_set(int type, unsigned long value);
 void energest_flush(void);
+unsigned long energest_process_time(struct process *p);
 
 #if ENERGEST_CONF_ON
 /*extern int energest_total_count;*/
@@ -121,10 +135,23 @@ extern energest_t energest_leveldevice_current_leveltime[ENERGEST_CONF_LEVELDEVI
 #endif
 
 
+#if ENERGEST_CONF_PROCESSES
+struct process *energest_process_enter(struct process *p);
+void energest_process_leave(struct process *caller);
+
+#define ENERGEST_PROCESS_ENTER(caller, p) ((caller) = energest_process_enter(p))
+#define ENERGEST_PROCESS_LEAVE(caller)    energest_process_leave(caller)
+#else /* ENERGEST_CONF_PROCESSES */
+#define ENERGEST_PROCESS_ENTER(caller, p) do { } while(0)
+#define ENERGEST_PROCESS_LEAVE(caller)    do { } while(0)
+#endif /* ENERGEST_CONF_PROCESSES */
+
 #else /* ENERGEST_CONF_ON */
 #define ENERGEST_ON(type) do { } while(0)
 #define ENERGEST_OFF(type) do { } while(0)
 #define ENERGEST_OFF_LEVEL(type,level) do { } while(0)
+#define ENERGEST_PROCESS_ENTER(caller, p) do { } while(0)
+#define ENERGEST_PROCESS_LEAVE(caller)    do { } while(0)
 #endif /* ENERGEST_CONF_ON */
 
 #endif /* __ENERGEST_H__ */
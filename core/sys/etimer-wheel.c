@@ -0,0 +1,463 @@
+/**
+ * \addtogroup etimer
+ * @{
+ */
+
+/**
+ * \file
+ * Event timer library implementation on a hierarchical timing wheel.
+ * \author
+ * Adam Dunkels <adam@sics.se>
+ */
+
+/*
+ * Copyright (c) 2004, Swedish Institute of Computer Science.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the Institute nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE INSTITUTE AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE INSTITUTE OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ *
+ * This file is part of the Contiki operating system.
+ */
+
+/*
+ * The pending timers are kept in ETIMER_CONF_WHEEL_LEVELS levels of
+ * SLOTS lists each. A timer that expires less than SLOTS ticks after
+ * wheel_time is kept in level 0, in the slot given by the low bits of
+ * its expiration time. Timers further away go into higher levels,
+ * where each slot covers SLOTS times as many ticks as a slot of the
+ * level below. When wheel_time reaches the start of a slot of a
+ * higher level, the timers of that slot are moved down ("cascaded").
+ *
+ * Each timer remembers its slot and the link that points to it, so it
+ * is unlinked without walking the list. Timers that have expired but
+ * whose event could not yet be posted are kept on the expired list.
+ */
+
+#include "contiki-conf.h"
+
+#include "sys/etimer.h"
+#include "sys/process.h"
+
+#if ETIMER_CONF_WHEEL
+
+#define BITS    ETIMER_CONF_WHEEL_BITS
+#define LEVELS  ETIMER_CONF_WHEEL_LEVELS
+#define SLOTS   (1 << BITS)
+#define MASK    ((clock_time_t)(SLOTS - 1))
+
+#define SLOT_EXPIRED (LEVELS * SLOTS)
+#define SLOT_NONE    (SLOT_EXPIRED + 1)
+
+#if SLOT_NONE > 255
+#error "ETIMER_CONF_WHEEL_LEVELS * 2^ETIMER_CONF_WHEEL_BITS must be below 255"
+#endif
+
+#define EXPIRATION(t) ((t)->timer.start + (t)->timer.interval)
+#if ETIMER_CONF_SLACK
+#define DEADLINE(t)   (EXPIRATION(t) + (t)->slack)
+#else /* ETIMER_CONF_SLACK */
+#define DEADLINE(t)   EXPIRATION(t)
+#endif /* ETIMER_CONF_SLACK */
+#define MAX_TICKS     (((clock_time_t)~(clock_time_t)0) / 2)
+
+/* The ticks of one slot in a level and the index of a time in it. */
+#define LEVEL_SHIFT(l)    ((l) * BITS)
+#define INDEX(time, l)    (((time) >> LEVEL_SHIFT(l)) & MASK)
+
+/* Slots 0..SLOTS-1 are level 0, then level 1 and so on. The extra
+   list head at SLOT_EXPIRED is the expired list. */
+static struct etimer *slots[SLOT_EXPIRED + 1];
+static unsigned short level_count[LEVELS];
+static unsigned short count;
+
+/* All timers that expire at or before wheel_time have been moved to
+   the expired list. */
+static clock_time_t wheel_time;
+static clock_time_t next_expiration;
+
+PROCESS(etimer_process, "Event timer");
+/*---------------------------------------------------------------------------*/
+static void
+push(struct etimer *t, unsigned char slot)
+{
+  t->slot = slot;
+  t->next = slots[slot];
+  if(t->next != NULL) {
+    t->next->pprev = &t->next;
+  }
+  t->pprev = &slots[slot];
+  slots[slot] = t;
+}
+/*---------------------------------------------------------------------------*/
+static void
+insert(struct etimer *t)
+{
+  clock_time_t expiration, delta;
+  unsigned char level, slot;
+
+  expiration = EXPIRATION(t);
+  delta = expiration - wheel_time;
+
+  if(delta == 0 || delta > MAX_TICKS) {
+    /* Already expired, or expiring at the current tick which has
+       already been handled. */
+    slot = SLOT_EXPIRED;
+  } else {
+    for(level = 0; level < LEVELS - 1; level++) {
+      if((delta >> LEVEL_SHIFT(level + 1)) == 0) {
+        break;
+      }
+    }
+    if(level == LEVELS - 1 && (delta >> LEVEL_SHIFT(level)) >= SLOTS - 1) {
+      /* At or beyond the range of the wheel: park the timer in the
+         top level slot that is cascaded last. It is put back in when
+         that slot is cascaded. */
+      slot = (INDEX(wheel_time, level) + MASK) & MASK;
+    } else {
+      slot = INDEX(expiration, level);
+    }
+    slot += level * SLOTS;
+    level_count[level]++;
+  }
+
+  push(t, slot);
+}
+/*---------------------------------------------------------------------------*/
+static int
+remove_timer(struct etimer *t)
+{
+  if(t->slot >= SLOT_NONE) {
+    return 0;
+  }
+  *t->pprev = t->next;
+  if(t->next != NULL) {
+    t->next->pprev = t->pprev;
+  }
+  if(t->slot != SLOT_EXPIRED) {
+    level_count[t->slot / SLOTS]--;
+  }
+  t->slot = SLOT_NONE;
+  t->next = NULL;
+  return 1;
+}
+/*---------------------------------------------------------------------------*/
+static void
+update_time(void)
+{
+  struct etimer *t;
+  clock_time_t tdist, d;
+  unsigned char level, i;
+  int found;
+
+  if(count == 0) {
+    next_expiration = 0;
+    return;
+  }
+  if(slots[SLOT_EXPIRED] != NULL) {
+    next_expiration = wheel_time;
+    return;
+  }
+
+  /* Within a level, the slots after the current one hold timers in
+     order of expiration time. Their deadlines can be later than that
+     because of the slack, so keep looking until a slot starts after
+     the earliest deadline found. Distances are counted from
+     wheel_time, to take care of wraps; all timers on the wheel expire
+     after it. */
+  tdist = 0;
+  found = 0;
+  for(level = 0; level < LEVELS; level++) {
+    if(level_count[level] == 0) {
+      continue;
+    }
+    for(i = 1; i <= SLOTS; i++) {
+      d = (clock_time_t)((((wheel_time >> LEVEL_SHIFT(level)) + i)
+                          << LEVEL_SHIFT(level)) - wheel_time);
+      if(found && d >= tdist) {
+        break;
+      }
+      t = slots[level * SLOTS + ((INDEX(wheel_time, level) + i) & MASK)];
+      for(; t != NULL; t = t->next) {
+        d = (clock_time_t)(DEADLINE(t) - wheel_time);
+        if(!found || d < tdist) {
+          tdist = d;
+          found = 1;
+        }
+      }
+    }
+  }
+  next_expiration = wheel_time + tdist;
+}
+/*---------------------------------------------------------------------------*/
+static void
+cascade(unsigned char slot)
+{
+  struct etimer *t, *next;
+
+  t = slots[slot];
+  slots[slot] = NULL;
+  for(; t != NULL; t = next) {
+    next = t->next;
+    level_count[slot / SLOTS]--;
+    insert(t);
+  }
+}
+/*---------------------------------------------------------------------------*/
+static void
+advance(clock_time_t now)
+{
+  struct etimer *t;
+  clock_time_t last;
+  unsigned char level, index;
+
+  while(wheel_time != now) {
+    /* Nothing can happen before the next slot boundary of the lowest
+       non-empty level, so skip straight to the tick before it. */
+    for(level = 0; level < LEVELS && level_count[level] == 0; level++);
+    if(level == LEVELS) {
+      wheel_time = now;
+      break;
+    }
+    if(level > 0) {
+      last = wheel_time | (((clock_time_t)1 << LEVEL_SHIFT(level)) - 1);
+      if((clock_time_t)(now - wheel_time) <= (clock_time_t)(last - wheel_time)) {
+        wheel_time = now;
+        break;
+      }
+      wheel_time = last;
+    }
+
+    wheel_time++;
+
+    /* Cascade the higher levels whose slot boundary we just crossed. */
+    index = INDEX(wheel_time, 0);
+    for(level = 1; index == 0 && level < LEVELS; level++) {
+      index = INDEX(wheel_time, level);
+      cascade(level * SLOTS + index);
+    }
+
+    /* Move the timers of this tick to the expired list. */
+    t = slots[INDEX(wheel_time, 0)];
+    slots[INDEX(wheel_time, 0)] = NULL;
+    while(t != NULL) {
+      struct etimer *next = t->next;
+      level_count[0]--;
+      push(t, SLOT_EXPIRED);
+      t = next;
+    }
+  }
+}
+/*---------------------------------------------------------------------------*/
+PROCESS_THREAD(etimer_process, ev, data)
+{
+  struct etimer *t;
+  unsigned char i;
+
+  PROCESS_BEGIN();
+
+  for(i = 0; i <= SLOT_EXPIRED; i++) {
+    slots[i] = NULL;
+  }
+  for(i = 0; i < LEVELS; i++) {
+    level_count[i] = 0;
+  }
+  count = 0;
+  wheel_time = clock_time();
+
+  while(1) {
+    PROCESS_YIELD();
+
+    if(ev == PROCESS_EVENT_EXITED) {
+      struct process *p = data;
+
+      for(i = 0; i <= SLOT_EXPIRED; i++) {
+        t = slots[i];
+        while(t != NULL) {
+          struct etimer *next = t->next;
+          if(t->p == p) {
+            remove_timer(t);
+            count--;
+          }
+          t = next;
+        }
+      }
+      update_time();
+      continue;
+    } else if(ev != PROCESS_EVENT_POLL) {
+      continue;
+    }
+
+    advance(clock_time());
+
+    while(slots[SLOT_EXPIRED] != NULL) {
+      t = slots[SLOT_EXPIRED];
+      if(process_post(t->p, PROCESS_EVENT_TIMER, t) != PROCESS_ERR_OK) {
+        etimer_request_poll();
+        break;
+      }
+      /* Reset the process ID of the event timer, to signal that the
+         etimer has expired. This is later checked in the
+         etimer_expired() function. */
+      remove_timer(t);
+      t->p = PROCESS_NONE;
+      count--;
+    }
+    update_time();
+  }
+
+  PROCESS_END();
+}
+/*---------------------------------------------------------------------------*/
+void
+etimer_request_poll(void)
+{
+  process_poll(&etimer_process);
+}
+/*---------------------------------------------------------------------------*/
+static void
+add_timer(struct etimer *timer)
+{
+  etimer_request_poll();
+
+  if(timer->p == PROCESS_NONE || !remove_timer(timer)) {
+    count++;
+  }
+
+  timer->p = PROCESS_CURRENT();
+  insert(timer);
+
+  /* Only move next_expiration earlier here; if this timer was the
+     earliest one and was moved later, the etimer process will catch
+     up when it is polled at the old expiration time. */
+  if(timer->slot == SLOT_EXPIRED) {
+    next_expiration = wheel_time;
+  } else if(count == 1) {
+    next_expiration = DEADLINE(timer);
+  } else {
+    clock_time_t now = clock_time();
+
+    if((clock_time_t)(next_expiration - now - 1) < MAX_TICKS &&
+       (clock_time_t)(DEADLINE(timer) - now) <
+       (clock_time_t)(next_expiration - now)) {
+      next_expiration = DEADLINE(timer);
+    }
+  }
+}
+/*---------------------------------------------------------------------------*/
+void
+etimer_set(struct etimer *et, clock_time_t interval)
+{
+#if ETIMER_CONF_SLACK
+  et->slack = 0;
+#endif /* ETIMER_CONF_SLACK */
+  timer_set(&et->timer, interval);
+  add_timer(et);
+}
+/*---------------------------------------------------------------------------*/
+#if ETIMER_CONF_SLACK
+void
+etimer_set_slack(struct etimer *et, clock_time_t interval, clock_time_t slack)
+{
+  et->slack = slack;
+  timer_set(&et->timer, interval);
+  add_timer(et);
+}
+#endif /* ETIMER_CONF_SLACK */
+/*---------------------------------------------------------------------------*/
+void
+etimer_reset(struct etimer *et)
+{
+  timer_reset(&et->timer);
+  add_timer(et);
+}
+/*---------------------------------------------------------------------------*/
+void
+etimer_restart(struct etimer *et)
+{
+  timer_restart(&et->timer);
+  add_timer(et);
+}
+/*---------------------------------------------------------------------------*/
+void
+etimer_adjust(struct etimer *et, int timediff)
+{
+  et->timer.start += timediff;
+  if(et->p != PROCESS_NONE && remove_timer(et)) {
+    insert(et);
+  }
+  update_time();
+}
+/*---------------------------------------------------------------------------*/
+int
+etimer_expired(struct etimer *et)
+{
+  return et->p == PROCESS_NONE;
+}
+/*---------------------------------------------------------------------------*/
+clock_time_t
+etimer_expiration_time(struct etimer *et)
+{
+  return et->timer.start + et->timer.interval;
+}
+/*---------------------------------------------------------------------------*/
+clock_time_t
+etimer_start_time(struct etimer *et)
+{
+  return et->timer.start;
+}
+/*---------------------------------------------------------------------------*/
+int
+etimer_pending(void)
+{
+  return count != 0;
+}
+/*---------------------------------------------------------------------------*/
+clock_time_t
+etimer_next_expiration_time(void)
+{
+  return etimer_pending() ? next_expiration : 0;
+}
+/*---------------------------------------------------------------------------*/
+void
+etimer_stop(struct etimer *et)
+{
+  if(et->p != PROCESS_NONE && remove_timer(et)) {
+    count--;
+    /* A next_expiration that is too early only costs a spurious poll
+       of the etimer process, so the wheel is only scanned again when
+       this timer was the one it was set for. */
+    if(DEADLINE(et) == next_expiration) {
+      update_time();
+    }
+  }
+
+  /* Remove the next pointer from the item to be removed. */
+  et->next = NULL;
+  /* Set the timer as expired */
+  et->p = PROCESS_NONE;
+}
+/*---------------------------------------------------------------------------*/
+#endif /* ETIMER_CONF_WHEEL */
+/** @} */
@@ -50,6 +50,14 @@
 #include "sys/etimer.h"
 #include "sys/process.h"
 
+#if !ETIMER_CONF_WHEEL
+
+#if ETIMER_CONF_SLACK
+#define DEADLINE(t) ((t)->timer.start + (t)->timer.interval + (t)->slack)
+#else /* ETIMER_CONF_SLACK */
+#define DEADLINE(t) ((t)->timer.start + (t)->timer.interval)
+#endif /* ETIMER_CONF_SLACK */
+
 static struct etimer *timerlist;
 static clock_time_t next_expiration;
 
@@ -68,10 +76,10 @@ update_time(void)
     now = clock_time();
     t = timerlist;
     /* Must calculate distance to next time into account due to wraps */
-    tdist = t->timer.start + t->timer.interval - now;
+    tdist = DEADLINE(t) - now;
     for(t = t->next; t != NULL; t = t->next) {
-      if(t->timer.start + t->timer.interval - now < tdist) {
-	tdist = t->timer.start + t->timer.interval - now;
+      if(DEADLINE(t) - now < tdist) {
+	tdist = DEADLINE(t) - now;
       }
     }
     next_expiration = now + tdist;
@@ -177,9 +185,22 @@ add_timer(struct etimer *timer)
 void
 etimer_set(struct etimer *et, clock_time_t interval)
 {
+#if ETIMER_CONF_SLACK
+  et->slack = 0;
+#endif /* ETIMER_CONF_SLACK */
+  timer_set(&et->timer, interval);
+  add_timer(et);
+}
+/*---------------------------------------------------------------------------*/
+#if ETIMER_CONF_SLACK
+void
+etimer_set_slack(struct etimer *et, clock_time_t interval, clock_time_t slack)
+{
+  et->slack = slack;
   timer_set(&et->timer, interval);
   add_timer(et);
 }
+#endif /* ETIMER_CONF_SLACK */
 /*---------------------------------------------------------------------------*/
 void
 etimer_reset(struct etimer *et)
@@ -262,4 +283,5 @@ etimer_stop(struct etimer *et)
   et->p = PROCESS_NONE;
 }
 /*---------------------------------------------------------------------------*/
+#endif /* !ETIMER_CONF_WHEEL */
 /** @} */
@@ -66,6 +66,40 @@
 #include "sys/timer.h"
 #include "sys/process.h"
 
+/**
+ * Select the hierarchical timing wheel backend (etimer-wheel.c)
+ * instead of the single unsorted list of etimer.c. The wheel keeps
+ * insert, stop and expiry cost independent of the number of pending
+ * timers, at the cost of a fixed table of list heads and a back
+ * pointer in each etimer.
+ */
+#ifndef ETIMER_CONF_WHEEL
+#define ETIMER_CONF_WHEEL 0
+#endif /* ETIMER_CONF_WHEEL */
+
+#if ETIMER_CONF_WHEEL
+/** Log2 of the number of slots in each level of the wheel. */
+#ifndef ETIMER_CONF_WHEEL_BITS
+#define ETIMER_CONF_WHEEL_BITS 4
+#endif /* ETIMER_CONF_WHEEL_BITS */
+
+/** The number of levels of the wheel. Each level covers
+    ETIMER_CONF_WHEEL_BITS more bits of the clock than the one below;
+    timers further away than all levels are parked in the top level
+    until they come into range. */
+#ifndef ETIMER_CONF_WHEEL_LEVELS
+#define ETIMER_CONF_WHEEL_LEVELS 4
+#endif /* ETIMER_CONF_WHEEL_LEVELS */
+#endif /* ETIMER_CONF_WHEEL */
+
+/**
+ * Let timers carry a slack, a number of ticks by which they may fire
+ * late (see etimer_set_slack()). Costs one clock_time_t per etimer.
+ */
+#ifndef ETIMER_CONF_SLACK
+#define ETIMER_CONF_SLACK 0
+#endif /* ETIMER_CONF_SLACK */
+
 /**
  * A timer.
  *
@@ -78,6 +112,13 @@ struct etimer {
   struct timer timer;
   struct etimer *next;
   struct process *p;
+#if ETIMER_CONF_WHEEL
+  struct etimer **pprev;
+  unsigned char slot;
+#endif /* ETIMER_CONF_WHEEL */
+#if ETIMER_CONF_SLACK
+  clock_time_t slack;
+#endif /* ETIMER_CONF_SLACK */
 };
 
 /**
@@ -98,6 +139,30 @@ struct etimer {
  */
 CCIF void etimer_set(struct etimer *et, clock_time_t interval);
 
+/**
+ * \brief      Set an event timer that may fire late.
+ * \param et   A pointer to the event timer
+ * \param interval The interval before the timer expires.
+ * \param slack The number of ticks the timer may fire after the
+ *             interval has passed.
+ *
+ *             This function works like etimer_set(), but allows the
+ *             timer to expire anywhere within slack ticks after the
+ *             interval. etimer_next_expiration_time() returns the
+ *             last tick by which a timer must fire, so timers whose
+ *             windows overlap are handled in a single wakeup of the
+ *             system. The slack is kept by etimer_reset() and
+ *             etimer_restart(), and cleared by etimer_set().
+ *
+ *             Without ETIMER_CONF_SLACK the slack is ignored.
+ */
+#if ETIMER_CONF_SLACK
+CCIF void etimer_set_slack(struct etimer *et, clock_time_t interval,
+                           clock_time_t slack);
+#else /* ETIMER_CONF_SLACK */
+#define etimer_set_slack(et, interval, slack) etimer_set(et, interval)
+#endif /* ETIMER_CONF_SLACK */
+
 /**
  * \brief      Reset an event timer with the same interval as was
  *             previously set.
@@ -229,7 +294,8 @@ int etimer_pending(void);
  *	       returns 0.
  *
  *             This functions returns next expiration time of all
- *             pending event timers.
+ *             pending event timers. For timers with slack, this is
+ *             the last tick at which they may fire.
  */
 clock_time_t etimer_next_expiration_time(void);
 
@@ -48,6 +48,8 @@
 
 #include "sys/process.h"
 #include "sys/arg.h"
+#include "sys/energest.h"
+#include "sys/proctrace.h"
 
 /*
  * Pointer to the currently running process structure.
@@ -64,17 +66,71 @@ struct event_data {
   process_event_t ev;
   process_data_t data;
   struct process *p;
+#if PROCESS_CONF_PRIORITIES > 1
+  process_num_events_t next;
+#endif /* PROCESS_CONF_PRIORITIES > 1 */
 };
 
-static process_num_events_t nevents, fevent;
+static process_num_events_t nevents;
 static struct event_data events[PROCESS_CONF_NUMEVENTS];
 
+#if PROCESS_CONF_PRIORITIES > 1
+/*
+ * With several priorities, the event slots are linked into one FIFO
+ * per priority and a list of free slots, using the slot index as
+ * link. EVENT_NONE terminates a list.
+ */
+#define EVENT_NONE PROCESS_CONF_NUMEVENTS
+static process_num_events_t fevent[PROCESS_CONF_PRIORITIES];
+static process_num_events_t levent[PROCESS_CONF_PRIORITIES];
+static process_num_events_t nevents_priority[PROCESS_CONF_PRIORITIES];
+static process_num_events_t freeevent;
+#else /* PROCESS_CONF_PRIORITIES > 1 */
+static process_num_events_t fevent;
+#endif /* PROCESS_CONF_PRIORITIES > 1 */
+
 #if PROCESS_CONF_STATS
 process_num_events_t process_maxevents;
+#if PROCESS_CONF_PRIORITIES > 1
+process_num_events_t process_maxevents_priority[PROCESS_CONF_PRIORITIES];
+#endif /* PROCESS_CONF_PRIORITIES > 1 */
 #endif
 
 static volatile unsigned char poll_requested;
 
+#if PROCESS_CONF_POLL_LIST
+/*
+ * The processes that have requested a poll, most recent first,
+ * linked through their nextpoll field.
+ */
+static struct process *volatile poll_list;
+
+#ifdef PROCESS_CONF_POLL_LOCK
+#define POLL_LOCK(s)   PROCESS_CONF_POLL_LOCK(s)
+#define POLL_UNLOCK(s) PROCESS_CONF_POLL_UNLOCK(s)
+#else /* PROCESS_CONF_POLL_LOCK */
+#define POLL_LOCK(s)   ((s) = 0)
+#define POLL_UNLOCK(s) ((void)(s))
+#endif /* PROCESS_CONF_POLL_LOCK */
+#endif /* PROCESS_CONF_POLL_LIST */
+
+#if PROCESS_CONF_SUBSCRIPTIONS
+/*
+ * The broadcast subscriptions of all processes. A free entry has a
+ * NULL process.
+ */
+struct subscription {
+  struct process *p;
+  process_event_t ev;
+};
+
+static struct subscription subscriptions[PROCESS_CONF_SUBSCRIPTIONS];
+
+static struct subscription *find_subscription(struct process *p,
+                                              process_event_t ev);
+static void remove_subscriptions(struct process *p);
+#endif /* PROCESS_CONF_SUBSCRIPTIONS */
+
 #define PROCESS_STATE_NONE        0
 #define PROCESS_STATE_RUNNING     1
 #define PROCESS_STATE_CALLED      2
@@ -158,6 +214,10 @@ exit_process(struct process *p, struct process *fromprocess)
     }
   }
 
+#if PROCESS_CONF_SUBSCRIPTIONS
+  remove_subscriptions(p);
+#endif /* PROCESS_CONF_SUBSCRIPTIONS */
+
   if(p == process_list) {
     process_list = process_list->next;
   } else {
@@ -176,6 +236,12 @@ static void
 call_process(struct process *p, process_event_t ev, process_data_t data)
 {
   int ret;
+#if ENERGEST_CONF_ON && ENERGEST_CONF_PROCESSES
+  struct process *caller;
+#endif /* ENERGEST_CONF_ON && ENERGEST_CONF_PROCESSES */
+#if PROCTRACE_CONF_SIZE
+  rtimer_clock_t start;
+#endif /* PROCTRACE_CONF_SIZE */
 
 #if DEBUG
   if(p->state == PROCESS_STATE_CALLED) {
@@ -188,7 +254,11 @@ call_process(struct process *p, process_event_t ev, process_data_t data)
     PRINTF("process: calling process '%s' with event %d\n", PROCESS_NAME_STRING(p), ev);
     process_current = p;
     p->state = PROCESS_STATE_CALLED;
+    ENERGEST_PROCESS_ENTER(caller, p);
+    PROCTRACE_RUN_BEGIN(start);
     ret = p->thread(&p->pt, ev, data);
+    PROCTRACE_RUN_END(start, p, ev);
+    ENERGEST_PROCESS_LEAVE(caller);
     if(ret == PT_EXITED ||
        ret == PT_ENDED ||
        ev == PROCESS_EVENT_EXIT) {
@@ -210,18 +280,82 @@ process_init(void)
 {
   lastevent = PROCESS_EVENT_MAX;
 
-  nevents = fevent = 0;
+  nevents = 0;
+#if PROCESS_CONF_PRIORITIES > 1
+  {
+    process_num_events_t i;
+
+    for(i = 0; i < PROCESS_CONF_PRIORITIES; i++) {
+      fevent[i] = levent[i] = EVENT_NONE;
+      nevents_priority[i] = 0;
+#if PROCESS_CONF_STATS
+      process_maxevents_priority[i] = 0;
+#endif /* PROCESS_CONF_STATS */
+    }
+    for(i = 0; i < PROCESS_CONF_NUMEVENTS; i++) {
+      events[i].next = i + 1;
+    }
+    freeevent = 0;
+  }
+#else /* PROCESS_CONF_PRIORITIES > 1 */
+  fevent = 0;
+#endif /* PROCESS_CONF_PRIORITIES > 1 */
 #if PROCESS_CONF_STATS
   process_maxevents = 0;
 #endif /* PROCESS_CONF_STATS */
 
   process_current = process_list = NULL;
+#if PROCESS_CONF_SUBSCRIPTIONS
+  {
+    unsigned char i;
+
+    for(i = 0; i < PROCESS_CONF_SUBSCRIPTIONS; i++) {
+      subscriptions[i].p = NULL;
+    }
+  }
+#endif /* PROCESS_CONF_SUBSCRIPTIONS */
+#if PROCESS_CONF_POLL_LIST
+  poll_list = NULL;
+#endif /* PROCESS_CONF_POLL_LIST */
 }
 /*---------------------------------------------------------------------------*/
 /*
  * Call each process' poll handler.
  */
 /*---------------------------------------------------------------------------*/
+#if PROCESS_CONF_POLL_LIST
+static void
+do_poll(void)
+{
+  struct process *p, *next;
+  int s;
+
+  /* Detach the list of polled processes. Polls requested while we
+     call the processes below go on a new list and set poll_requested
+     again. */
+  POLL_LOCK(s);
+  p = poll_list;
+  poll_list = NULL;
+  poll_requested = 0;
+  POLL_UNLOCK(s);
+
+  while(p != NULL) {
+    /* Once needspoll is cleared, the process may be put on the new
+       list, which overwrites nextpoll. */
+    POLL_LOCK(s);
+    next = p->nextpoll;
+    p->needspoll = 0;
+    POLL_UNLOCK(s);
+
+    /* The process may have exited after requesting the poll. */
+    if(p->state != PROCESS_STATE_NONE) {
+      p->state = PROCESS_STATE_RUNNING;
+      call_process(p, PROCESS_EVENT_POLL, NULL);
+    }
+    p = next;
+  }
+}
+#else /* PROCESS_CONF_POLL_LIST */
 static void
 do_poll(void)
 {
@@ -237,6 +371,7 @@ do_poll(void)
     }
   }
 }
+#endif /* PROCESS_CONF_POLL_LIST */
 /*---------------------------------------------------------------------------*/
 /*
  * Process the next event in the event queue and deliver it to
@@ -260,6 +395,28 @@ do_event(void)
    */
 
   if(nevents > 0) {
+#if PROCESS_CONF_PRIORITIES > 1
+    static process_num_events_t prio, first;
+
+    /* Take the oldest event of the highest priority that has any. */
+    for(prio = PROCESS_PRIORITY_HIGH; nevents_priority[prio] == 0; --prio);
+    first = fevent[prio];
+
+    ev = events[first].ev;
+    data = events[first].data;
+    receiver = events[first].p;
+
+    /* Unlink the event from its priority queue and put the slot back
+       on the free list. */
+    fevent[prio] = events[first].next;
+    if(fevent[prio] == EVENT_NONE) {
+      levent[prio] = EVENT_NONE;
+    }
+    events[first].next = freeevent;
+    freeevent = first;
+    --nevents_priority[prio];
+    --nevents;
+#else /* PROCESS_CONF_PRIORITIES > 1 */
     
     /* There are events that we should deliver. */
     ev = events[fevent].ev;
@@ -271,6 +428,7 @@ do_event(void)
        and decrese the number of events. */
     fevent = (fevent + 1) % PROCESS_CONF_NUMEVENTS;
     --nevents;
+#endif /* PROCESS_CONF_PRIORITIES > 1 */
 
     /* If this is a broadcast event, we deliver it to all events, in
        order of their priority. */
@@ -282,6 +440,13 @@ do_event(void)
 	if(poll_requested) {
 	  do_poll();
 	}
+#if PROCESS_CONF_SUBSCRIPTIONS
+	/* Processes with subscriptions only get the events they asked
+	   for. */
+	if(p->nsubscriptions != 0 && find_subscription(p, ev) == NULL) {
+	  continue;
+	}
+#endif /* PROCESS_CONF_SUBSCRIPTIONS */
 	call_process(p, ev, data);
       }
     } else {
@@ -319,8 +484,22 @@ process_nevents(void)
   return nevents + poll_requested;
 }
 /*---------------------------------------------------------------------------*/
+#if PROCESS_CONF_PRIORITIES > 1
+int
+process_post(struct process *p, process_event_t ev, process_data_t data)
+{
+  return process_post_priority(p, ev, data,
+                               p == PROCESS_BROADCAST ?
+                               PROCESS_PRIORITY_NORMAL : p->priority);
+}
+/*---------------------------------------------------------------------------*/
+int
+process_post_priority(struct process *p, process_event_t ev,
+                      process_data_t data, unsigned char priority)
+#else /* PROCESS_CONF_PRIORITIES > 1 */
 int
 process_post(struct process *p, process_event_t ev, process_data_t data)
+#endif /* PROCESS_CONF_PRIORITIES > 1 */
 {
   static process_num_events_t snum;
 
@@ -341,19 +520,44 @@ process_post(struct process *p, process_event_t ev, process_data_t data)
       printf("soft panic: event queue is full when event %d was posted to %s frpm %s\n", ev, PROCESS_NAME_STRING(p), PROCESS_NAME_STRING(process_current));
     }
 #endif /* DEBUG */
+    PROCTRACE_DROP(p, ev);
     return PROCESS_ERR_FULL;
   }
   
+#if PROCESS_CONF_PRIORITIES > 1
+  if(priority > PROCESS_PRIORITY_HIGH) {
+    priority = PROCESS_PRIORITY_HIGH;
+  }
+
+  /* Take a free slot and append it to the queue of this priority. */
+  snum = freeevent;
+  freeevent = events[snum].next;
+  events[snum].next = EVENT_NONE;
+  if(levent[priority] == EVENT_NONE) {
+    fevent[priority] = snum;
+  } else {
+    events[levent[priority]].next = snum;
+  }
+  levent[priority] = snum;
+  ++nevents_priority[priority];
+#else /* PROCESS_CONF_PRIORITIES > 1 */
   snum = (process_num_events_t)(fevent + nevents) % PROCESS_CONF_NUMEVENTS;
+#endif /* PROCESS_CONF_PRIORITIES > 1 */
   events[snum].ev = ev;
   events[snum].data = data;
   events[snum].p = p;
   ++nevents;
+  PROCTRACE_POST(p, ev, nevents);
 
 #if PROCESS_CONF_STATS
   if(nevents > process_maxevents) {
     process_maxevents = nevents;
   }
+#if PROCESS_CONF_PRIORITIES > 1
+  if(nevents_priority[priority] > process_maxevents_priority[priority]) {
+    process_maxevents_priority[priority] = nevents_priority[priority];
+  }
+#endif /* PROCESS_CONF_PRIORITIES > 1 */
 #endif /* PROCESS_CONF_STATS */
   
   return PROCESS_ERR_OK;
@@ -374,11 +578,96 @@ process_poll(struct process *p)
   if(p != NULL) {
     if(p->state == PROCESS_STATE_RUNNING ||
        p->state == PROCESS_STATE_CALLED) {
+#if PROCESS_CONF_POLL_LIST
+      int s;
+
+      PROCTRACE_POLL(p);
+      POLL_LOCK(s);
+      if(!p->needspoll) {
+        p->nextpoll = poll_list;
+        poll_list = p;
+      }
+      p->needspoll = 1;
+      poll_requested = 1;
+      POLL_UNLOCK(s);
+#else /* PROCESS_CONF_POLL_LIST */
+      PROCTRACE_POLL(p);
       p->needspoll = 1;
       poll_requested = 1;
+#endif /* PROCESS_CONF_POLL_LIST */
+    }
+  }
+}
+/*---------------------------------------------------------------------------*/
+#if PROCESS_CONF_PRIORITIES > 1
+void
+process_set_priority(struct process *p, unsigned char priority)
+{
+  if(priority > PROCESS_PRIORITY_HIGH) {
+    priority = PROCESS_PRIORITY_HIGH;
+  }
+  p->priority = priority;
+}
+#endif /* PROCESS_CONF_PRIORITIES > 1 */
+/*---------------------------------------------------------------------------*/
+#if PROCESS_CONF_SUBSCRIPTIONS
+static struct subscription *
+find_subscription(struct process *p, process_event_t ev)
+{
+  unsigned char i;
+
+  for(i = 0; i < PROCESS_CONF_SUBSCRIPTIONS; i++) {
+    if(subscriptions[i].p == p && subscriptions[i].ev == ev) {
+      return &subscriptions[i];
+    }
+  }
+  return NULL;
+}
+/*---------------------------------------------------------------------------*/
+static void
+remove_subscriptions(struct process *p)
+{
+  unsigned char i;
+
+  for(i = 0; i < PROCESS_CONF_SUBSCRIPTIONS; i++) {
+    if(subscriptions[i].p == p) {
+      subscriptions[i].p = NULL;
+    }
+  }
+  p->nsubscriptions = 0;
+}
+/*---------------------------------------------------------------------------*/
+int
+process_subscribe(process_event_t ev)
+{
+  unsigned char i;
+
+  if(find_subscription(PROCESS_CURRENT(), ev) != NULL) {
+    return PROCESS_ERR_OK;
+  }
+  for(i = 0; i < PROCESS_CONF_SUBSCRIPTIONS; i++) {
+    if(subscriptions[i].p == NULL) {
+      subscriptions[i].p = PROCESS_CURRENT();
+      subscriptions[i].ev = ev;
+      PROCESS_CURRENT()->nsubscriptions++;
+      return PROCESS_ERR_OK;
     }
   }
+  return PROCESS_ERR_FULL;
+}
+/*---------------------------------------------------------------------------*/
+void
+process_unsubscribe(process_event_t ev)
+{
+  struct subscription *s;
+
+  s = find_subscription(PROCESS_CURRENT(), ev);
+  if(s != NULL) {
+    s->p = NULL;
+    PROCESS_CURRENT()->nsubscriptions--;
+  }
 }
+#endif /* PROCESS_CONF_SUBSCRIPTIONS */
 /*---------------------------------------------------------------------------*/
 int
 process_is_running(struct process *p)
@@ -89,6 +89,53 @@ typedef unsigned char process_num_events_t;
 #define PROCESS_CONF_NUMEVENTS 32
 #endif /* PROCESS_CONF_NUMEVENTS */
 
+/**
+ * \name Event priorities
+ * @{
+ */
+
+/**
+ * The number of event priority levels. With more than one level,
+ * each priority gets its own FIFO in the event queue and
+ * process_run() always delivers the oldest event of the highest
+ * non-empty priority first. The event slots are shared between all
+ * priorities, so this does not change the size of the event queue.
+ */
+#ifndef PROCESS_CONF_PRIORITIES
+#define PROCESS_CONF_PRIORITIES 1
+#endif /* PROCESS_CONF_PRIORITIES */
+
+/** The priority of processes that have not been given one. */
+#define PROCESS_PRIORITY_NORMAL 0
+/** The highest priority available in this configuration. */
+#define PROCESS_PRIORITY_HIGH   (PROCESS_CONF_PRIORITIES - 1)
+
+/* @} */
+
+/**
+ * Keep the processes that have requested a poll on a list of their
+ * own, so that the cost of dispatching polls depends on the number
+ * of polled processes rather than on the number of processes.
+ *
+ * process_poll() is typically called from interrupt handlers, so the
+ * list is guarded by PROCESS_CONF_POLL_LOCK(s) and
+ * PROCESS_CONF_POLL_UNLOCK(s), which save the interrupt state in the
+ * int variable s, mask interrupts and restore them again. Platforms
+ * that poll processes from interrupt context must define both before
+ * enabling this.
+ */
+#ifndef PROCESS_CONF_POLL_LIST
+#define PROCESS_CONF_POLL_LIST 0
+#endif /* PROCESS_CONF_POLL_LIST */
+
+/**
+ * The number of broadcast subscriptions that can be held at the same
+ * time, by all processes together. Zero disables process_subscribe().
+ */
+#ifndef PROCESS_CONF_SUBSCRIPTIONS
+#define PROCESS_CONF_SUBSCRIPTIONS 0
+#endif /* PROCESS_CONF_SUBSCRIPTIONS */
+
 #define PROCESS_EVENT_NONE            0x80
 #define PROCESS_EVENT_INIT            0x81
 #define PROCESS_EVENT_POLL            0x82
@@ -324,6 +371,18 @@ struct process {
   PT_THREAD((* thread)(struct pt *, process_event_t, process_data_t));
   struct pt pt;
   unsigned char state, needspoll;
+#if PROCESS_CONF_PRIORITIES > 1
+  unsigned char priority;
+#endif /* PROCESS_CONF_PRIORITIES > 1 */
+#if PROCESS_CONF_POLL_LIST
+  struct process *nextpoll;
+#endif /* PROCESS_CONF_POLL_LIST */
+#if PROCESS_CONF_SUBSCRIPTIONS
+  unsigned char nsubscriptions;
+#endif /* PROCESS_CONF_SUBSCRIPTIONS */
+#if ENERGEST_CONF_ON && ENERGEST_CONF_PROCESSES
+  unsigned long energest_cpu;
+#endif /* ENERGEST_CONF_ON && ENERGEST_CONF_PROCESSES */
 };
 
 /**
@@ -365,6 +424,53 @@ CCIF void process_start(struct process *p, const char *arg);
  */
 CCIF int process_post(struct process *p, process_event_t ev, void* data);
 
+#if PROCESS_CONF_PRIORITIES > 1
+/**
+ * Post an asynchronous event with an explicit priority.
+ *
+ * This function works like process_post(), but queues the event at
+ * the given priority instead of the priority of the receiving
+ * process. Events posted with process_post() are queued at the
+ * priority of the receiver, or at PROCESS_PRIORITY_NORMAL for
+ * broadcast events.
+ *
+ * \param p The process to which the event should be posted, or
+ * PROCESS_BROADCAST if the event should be posted to all processes.
+ *
+ * \param ev The event to be posted.
+ *
+ * \param data The auxiliary data to be sent with the event
+ *
+ * \param priority The priority, from PROCESS_PRIORITY_NORMAL up to
+ * PROCESS_PRIORITY_HIGH. Larger values are clamped.
+ *
+ * \retval PROCESS_ERR_OK The event could be posted.
+ *
+ * \retval PROCESS_ERR_FULL The event queue was full and the event could
+ * not be posted.
+ */
+CCIF int process_post_priority(struct process *p, process_event_t ev,
+                               void* data, unsigned char priority);
+
+/**
+ * Set the priority of a process.
+ *
+ * Events posted to the process with process_post() are queued at
+ * this priority. A high priority process that keeps posting events
+ * to itself, e.g. with PROCESS_PAUSE(), starves all processes of
+ * lower priority.
+ *
+ * \param p The process.
+ *
+ * \param priority The priority, from PROCESS_PRIORITY_NORMAL up to
+ * PROCESS_PRIORITY_HIGH. Larger values are clamped.
+ */
+CCIF void process_set_priority(struct process *p, unsigned char priority);
+#else /* PROCESS_CONF_PRIORITIES > 1 */
+#define process_post_priority(p, ev, data, priority) process_post(p, ev, data)
+#define process_set_priority(p, priority)
+#endif /* PROCESS_CONF_PRIORITIES > 1 */
+
 /**
  * Post a synchronous event to a process.
  *
@@ -378,6 +484,37 @@ CCIF int process_post(struct process *p, process_event_t ev, void* data);
 CCIF void process_post_synch(struct process *p,
 			     process_event_t ev, void* data);
 
+#if PROCESS_CONF_SUBSCRIPTIONS
+/**
+ * \brief      Subscribe the current process to a broadcast event
+ * \param ev   The event
+ * \retval PROCESS_ERR_OK The subscription was made.
+ * \retval PROCESS_ERR_FULL All PROCESS_CONF_SUBSCRIPTIONS subscriptions
+ *             are in use.
+ *
+ *             A process that has subscribed to at least one event
+ *             only receives the broadcast events it has subscribed
+ *             to. Processes without subscriptions receive all
+ *             broadcast events, as before. Events posted directly to
+ *             a process are always delivered. The subscriptions of a
+ *             process are dropped when it exits.
+ *
+ * \sa process_unsubscribe()
+ */
+CCIF int process_subscribe(process_event_t ev);
+
+/**
+ * \brief      Remove a subscription of the current process
+ * \param ev   The event
+ *
+ *             When the last subscription of a process is removed,
+ *             the process receives all broadcast events again.
+ *
+ * \sa process_subscribe()
+ */
+CCIF void process_unsubscribe(process_event_t ev);
+#endif /* PROCESS_CONF_SUBSCRIPTIONS */
+
 /**
  * \brief      Cause a process to exit
  * \param p    The process that is to be exited
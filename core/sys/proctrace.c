@@ -0,0 +1,118 @@
+/*
+ * Copyright (c) 2013, Swedish Institute of Computer Science.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the Institute nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE INSTITUTE AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE INSTITUTE OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ *
+ * This file is part of the Contiki operating system.
+ */
+
+/**
+ * \file
+ *         Process dispatch trace: a ring buffer of posts, polls and
+ *         process calls, with timestamps from the rtimer clock.
+ *         tools/proctrace/parse-proctrace turns a dump of the buffer
+ *         into per-process latency and run-time histograms.
+ */
+
+#include "sys/proctrace.h"
+
+#if PROCTRACE_CONF_SIZE
+
+#ifndef PROCTRACE_CONF_LOCK
+#define PROCTRACE_CONF_LOCK(s)   ((s) = 0)
+#define PROCTRACE_CONF_UNLOCK(s) ((void)(s))
+#endif /* PROCTRACE_CONF_LOCK */
+
+static struct proctrace_record records[PROCTRACE_CONF_SIZE];
+/* Index of the oldest record and the number of records held. */
+static unsigned short first, count;
+static unsigned char enabled = 1;
+
+unsigned short proctrace_overwritten;
+
+/*---------------------------------------------------------------------------*/
+void
+proctrace_add(unsigned char type, struct process *p, process_event_t ev,
+              rtimer_clock_t time, rtimer_clock_t arg)
+{
+  struct proctrace_record *r;
+  unsigned short i;
+  int s;
+
+  if(!enabled) {
+    return;
+  }
+
+  PROCTRACE_CONF_LOCK(s);
+  if(count == PROCTRACE_CONF_SIZE) {
+    i = first;
+    if(++first == PROCTRACE_CONF_SIZE) {
+      first = 0;
+    }
+    ++proctrace_overwritten;
+  } else {
+    i = first + count;
+    if(i >= PROCTRACE_CONF_SIZE) {
+      i -= PROCTRACE_CONF_SIZE;
+    }
+    ++count;
+  }
+  r = &records[i];
+  r->time = time;
+  r->arg = arg;
+  r->p = p;
+  r->type = type;
+  r->ev = ev;
+  PROCTRACE_CONF_UNLOCK(s);
+}
+/*---------------------------------------------------------------------------*/
+int
+proctrace_read(struct proctrace_record *r)
+{
+  int s;
+
+  PROCTRACE_CONF_LOCK(s);
+  if(count == 0) {
+    proctrace_overwritten = 0;
+    PROCTRACE_CONF_UNLOCK(s);
+    return 0;
+  }
+  *r = records[first];
+  if(++first == PROCTRACE_CONF_SIZE) {
+    first = 0;
+  }
+  --count;
+  PROCTRACE_CONF_UNLOCK(s);
+  return 1;
+}
+/*---------------------------------------------------------------------------*/
+void
+proctrace_enable(int on)
+{
+  enabled = on;
+}
+/*---------------------------------------------------------------------------*/
+#endif /* PROCTRACE_CONF_SIZE */
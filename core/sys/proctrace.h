@@ -0,0 +1,125 @@
+/*
+ * Copyright (c) 2013, Swedish Institute of Computer Science.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the Institute nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE INSTITUTE AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE INSTITUTE OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ *
+ * This file is part of the Contiki operating system.
+ */
+
+/**
+ * \file
+ *         Header file for the process dispatch trace
+ */
+
+#ifndef __PROCTRACE_H__
+#define __PROCTRACE_H__
+
+#include "contiki-conf.h"
+#include "sys/process.h"
+#include "sys/clock.h"
+#include "sys/rtimer.h"
+
+/**
+ * The number of records kept in the trace ring buffer. Zero disables
+ * tracing and all hooks compile to nothing. When the buffer is full
+ * the oldest record is overwritten.
+ *
+ * Records are added from interrupt handlers (process_poll()) as well
+ * as from the main loop, so the buffer is guarded by
+ * PROCTRACE_CONF_LOCK(s) and PROCTRACE_CONF_UNLOCK(s), which save the
+ * interrupt state in the int variable s, mask interrupts and restore
+ * them again.
+ */
+#ifndef PROCTRACE_CONF_SIZE
+#define PROCTRACE_CONF_SIZE 0
+#endif /* PROCTRACE_CONF_SIZE */
+
+enum proctrace_type {
+  /** An event was queued; arg is the queue length after the post. */
+  PROCTRACE_TYPE_POST,
+  /** An event was dropped because the queue was full. */
+  PROCTRACE_TYPE_DROP,
+  /** A poll was requested, often from an interrupt handler. */
+  PROCTRACE_TYPE_POLL,
+  /** A process was called; time is when the call started and arg is
+      how long it took. */
+  PROCTRACE_TYPE_RUN,
+};
+
+struct proctrace_record {
+  rtimer_clock_t time;
+  rtimer_clock_t arg;
+  struct process *p;
+  unsigned char type;
+  process_event_t ev;
+};
+
+#if PROCTRACE_CONF_SIZE
+
+void proctrace_add(unsigned char type, struct process *p, process_event_t ev,
+                   rtimer_clock_t time, rtimer_clock_t arg);
+
+/**
+ * \brief      Copy the oldest record out of the trace buffer
+ * \param r    Where to store the record
+ * \return     Non-zero if a record was copied, zero if the buffer is empty
+ */
+int proctrace_read(struct proctrace_record *r);
+
+/**
+ * \brief      Stop or restart recording
+ * \param on   Zero to stop, non-zero to record again
+ *
+ *             Recording is typically stopped while the buffer is
+ *             being read, so that the reader does not trace itself.
+ */
+void proctrace_enable(int on);
+
+/** The number of records overwritten since the buffer was last read empty. */
+extern unsigned short proctrace_overwritten;
+
+#define PROCTRACE_POST(p, ev, n)  proctrace_add(PROCTRACE_TYPE_POST, p, ev, \
+                                                RTIMER_NOW(), n)
+#define PROCTRACE_DROP(p, ev)     proctrace_add(PROCTRACE_TYPE_DROP, p, ev, \
+                                                RTIMER_NOW(), 0)
+#define PROCTRACE_POLL(p)         proctrace_add(PROCTRACE_TYPE_POLL, p, \
+                                                PROCESS_EVENT_POLL, \
+                                                RTIMER_NOW(), 0)
+#define PROCTRACE_RUN_BEGIN(t)    ((t) = RTIMER_NOW())
+#define PROCTRACE_RUN_END(t, p, ev) proctrace_add(PROCTRACE_TYPE_RUN, p, ev, \
+                                                  t, RTIMER_NOW() - (t))
+
+#else /* PROCTRACE_CONF_SIZE */
+
+#define PROCTRACE_POST(p, ev, n)    do { } while(0)
+#define PROCTRACE_DROP(p, ev)       do { } while(0)
+#define PROCTRACE_POLL(p)           do { } while(0)
+#define PROCTRACE_RUN_BEGIN(t)      do { } while(0)
+#define PROCTRACE_RUN_END(t, p, ev) do { } while(0)
+
+#endif /* PROCTRACE_CONF_SIZE */
+
+#endif /* __PROCTRACE_H__ */
@@ -56,7 +56,24 @@
 #define PRINTF(...)
 #endif
 
+#if RTIMER_CONF_QUEUE
+
+#ifndef RTIMER_CONF_LOCK
+#define RTIMER_CONF_LOCK(s)   ((s) = 0)
+#define RTIMER_CONF_UNLOCK(s) ((void)(s))
+#endif /* RTIMER_CONF_LOCK */
+
+/* Scheduled tasks, earliest deadline first. */
+static struct rtimer *queue;
+/* Set while rtimer_run_next() dispatches; it programs the compare
+   register itself when done. */
+static unsigned char running;
+
+unsigned short rtimer_missed_deadlines;
+
+#else /* RTIMER_CONF_QUEUE */
 static struct rtimer *next_rtimer;
+#endif /* RTIMER_CONF_QUEUE */
 
 /*---------------------------------------------------------------------------*/
 void
@@ -65,6 +82,132 @@ rtimer_init(void)
   rtimer_arch_init();
 }
 /*---------------------------------------------------------------------------*/
+#if RTIMER_CONF_QUEUE
+static void
+unlink_task(struct rtimer *rtimer)
+{
+  struct rtimer **pp;
+
+  for(pp = &queue; *pp != NULL; pp = &(*pp)->next) {
+    if(*pp == rtimer) {
+      *pp = rtimer->next;
+      return;
+    }
+  }
+}
+/*---------------------------------------------------------------------------*/
+int
+rtimer_set_priority(struct rtimer *rtimer, rtimer_clock_t time,
+                    rtimer_clock_t duration,
+                    rtimer_callback_t func, void *ptr,
+                    unsigned char priority)
+{
+  struct rtimer **pp, *head;
+  int s;
+
+  PRINTF("rtimer_set time %d priority %d\n", time, priority);
+
+  RTIMER_CONF_LOCK(s);
+  head = queue;
+  unlink_task(rtimer);
+
+  rtimer->func = func;
+  rtimer->ptr = ptr;
+  rtimer->time = time;
+  rtimer->priority = priority;
+
+  /* Equal deadlines are kept in priority order, then in the order
+     they were set. */
+  for(pp = &queue; *pp != NULL; pp = &(*pp)->next) {
+    if(RTIMER_CLOCK_LT(time, (*pp)->time) ||
+       (time == (*pp)->time && priority > (*pp)->priority)) {
+      break;
+    }
+  }
+  rtimer->next = *pp;
+  *pp = rtimer;
+
+  /* Reprogram the compare register if the head changed, or if the
+     task at the head was set again with a new deadline. */
+  if((queue != head || queue == rtimer) && !running) {
+    rtimer_arch_schedule(queue->time);
+  }
+  RTIMER_CONF_UNLOCK(s);
+  return RTIMER_OK;
+}
+/*---------------------------------------------------------------------------*/
+int
+rtimer_set(struct rtimer *rtimer, rtimer_clock_t time,
+	   rtimer_clock_t duration,
+	   rtimer_callback_t func, void *ptr)
+{
+  return rtimer_set_priority(rtimer, time, duration, func, ptr,
+                             RTIMER_PRIORITY_NORMAL);
+}
+/*---------------------------------------------------------------------------*/
+void
+rtimer_cancel(struct rtimer *rtimer)
+{
+  int s;
+
+  /* The compare register may still fire for the task; rtimer_run_next()
+     then finds nothing due and reprograms it. */
+  RTIMER_CONF_LOCK(s);
+  unlink_task(rtimer);
+  RTIMER_CONF_UNLOCK(s);
+}
+/*---------------------------------------------------------------------------*/
+void
+rtimer_run_next(void)
+{
+  struct rtimer *t, **pp, **best;
+  rtimer_clock_t now;
+  int s;
+
+  running = 1;
+  for(;;) {
+    RTIMER_CONF_LOCK(s);
+
+    /* Of the tasks that are due, run the one with the highest
+       priority. Normally only the head is due. */
+    now = RTIMER_NOW();
+    best = NULL;
+    for(pp = &queue;
+        *pp != NULL && !RTIMER_CLOCK_LT(now, (*pp)->time);
+        pp = &(*pp)->next) {
+      if(best == NULL || (*pp)->priority > (*best)->priority) {
+        best = pp;
+      }
+    }
+
+    if(best == NULL) {
+      if(queue == NULL) {
+        break;
+      }
+      rtimer_arch_schedule(queue->time);
+      /* If the deadline passed while the compare register was being
+         written, the interrupt would not come until the timer wraps. */
+      if(RTIMER_CLOCK_LT(RTIMER_NOW(), queue->time)) {
+        break;
+      }
+      RTIMER_CONF_UNLOCK(s);
+      continue;
+    }
+
+    t = *best;
+    *best = t->next;
+    RTIMER_CONF_UNLOCK(s);
+
+    if(RTIMER_CLOCK_LT(t->time + RTIMER_CONF_LATENESS, now)) {
+      rtimer_missed_deadlines++;
+    }
+    t->func(t, t->ptr);
+  }
+  running = 0;
+  RTIMER_CONF_UNLOCK(s);
+}
+/*---------------------------------------------------------------------------*/
+#else /* RTIMER_CONF_QUEUE */
 int
 rtimer_set(struct rtimer *rtimer, rtimer_clock_t time,
 	   rtimer_clock_t duration,
@@ -106,3 +249,4 @@ rtimer_run_next(void)
   return;
 }
 /*---------------------------------------------------------------------------*/
+#endif /* RTIMER_CONF_QUEUE */
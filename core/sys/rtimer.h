@@ -62,6 +62,35 @@ typedef unsigned short rtimer_clock_t;
 
 #include "rtimer-arch.h"
 
+/**
+ * Keep all scheduled real-time tasks on a queue ordered by deadline,
+ * instead of only the one that was set last. The compare register is
+ * always programmed for the earliest deadline. With this off,
+ * rtimer_set() replaces whatever task was scheduled before.
+ *
+ * rtimer_set() is called both from the main loop and from rtimer
+ * callbacks, so the queue is guarded by RTIMER_CONF_LOCK(s) and
+ * RTIMER_CONF_UNLOCK(s), which save the interrupt state in the int
+ * variable s, mask interrupts and restore them again. Platforms
+ * that set rtimers outside of interrupt context must define both.
+ */
+#ifndef RTIMER_CONF_QUEUE
+#define RTIMER_CONF_QUEUE 0
+#endif /* RTIMER_CONF_QUEUE */
+
+/**
+ * The number of ticks a task may run after its deadline before it is
+ * counted as a missed deadline, to allow for interrupt latency.
+ */
+#ifndef RTIMER_CONF_LATENESS
+#define RTIMER_CONF_LATENESS 2
+#endif /* RTIMER_CONF_LATENESS */
+
+/** The priority of tasks scheduled with rtimer_set(). */
+#define RTIMER_PRIORITY_NORMAL 0
+/** The highest task priority. */
+#define RTIMER_PRIORITY_HIGH   255
+
 /**
  * \brief      Initialize the real-time scheduler.
  *
@@ -82,6 +111,10 @@ typedef void (* rtimer_callback_t)(struct rtimer *t, void *ptr);
  *             support module for the real-time module.
  */
 struct rtimer {
+#if RTIMER_CONF_QUEUE
+  struct rtimer *next;
+  unsigned char priority;
+#endif /* RTIMER_CONF_QUEUE */
   rtimer_clock_t time;
   rtimer_callback_t func;
   void *ptr;
@@ -111,6 +144,44 @@ enum {
 int rtimer_set(struct rtimer *task, rtimer_clock_t time,
 	       rtimer_clock_t duration, rtimer_callback_t func, void *ptr);
 
+#if RTIMER_CONF_QUEUE
+/**
+ * \brief      Post a real-time task with a priority.
+ * \param task The task.
+ * \param time The time when the task is to be executed.
+ * \param duration Unused argument.
+ * \param func A function to be called when the task is executed.
+ * \param ptr An opaque pointer that will be supplied as an argument to the callback function.
+ * \param priority RTIMER_PRIORITY_NORMAL up to RTIMER_PRIORITY_HIGH.
+ * \return     RTIMER_OK.
+ *
+ *             Tasks run in deadline order. When several tasks are
+ *             due at once, e.g. because a callback overran, the one
+ *             with the highest priority runs first. Setting a task
+ *             that is already scheduled moves it to its new time.
+ */
+int rtimer_set_priority(struct rtimer *task, rtimer_clock_t time,
+                        rtimer_clock_t duration, rtimer_callback_t func,
+                        void *ptr, unsigned char priority);
+
+/**
+ * \brief      Remove a scheduled real-time task from the queue
+ * \param task The task
+ *
+ *             Does nothing if the task is not scheduled.
+ */
+void rtimer_cancel(struct rtimer *task);
+
+/**
+ * The number of tasks that ran more than RTIMER_CONF_LATENESS ticks
+ * after their deadline.
+ */
+extern unsigned short rtimer_missed_deadlines;
+#else /* RTIMER_CONF_QUEUE */
+#define rtimer_set_priority(task, time, duration, func, ptr, priority) \
+        rtimer_set(task, time, duration, func, ptr)
+#endif /* RTIMER_CONF_QUEUE */
+
 /**
  * \brief      Execute the next real-time task and schedule the next task, if any
  *
@@ -52,6 +52,9 @@ ISR(TIMERB1, cc2420_timerb1_interrupt)
   } else {
     cc2420_sfd_counter = 0;
     cc2420_sfd_end_time = TBCCR1;
+    if(cc2420_sfd_end_interrupt()) {
+      LPM4_EXIT;
+    }
   }
   ENERGEST_OFF(ENERGEST_TYPE_IRQ);
 }
@@ -49,11 +49,22 @@
 
 #define MAX_TICKS (~((clock_time_t)0) / 2)
 
+/* Longest time the CPU is left asleep without a clock interrupt when
+   tickless; the interrupt must come before TAR wraps past last_tar. */
+#define MAX_IDLE_TICKS (0x8000U / INTERVAL)
+
 static volatile unsigned long seconds;
 static volatile clock_time_t count = 0;
-/* last_tar is used for calculating clock_fine */
+/* last_tar is the timer value at the last clock tick; it is used for
+   counting ticks and for calculating clock_fine */
 static volatile uint16_t last_tar = 0;
 
+#if CLOCK_CONF_TICKLESS
+/* Set while the CPU sleeps with the compare register programmed for the
+   next etimer deadline instead of the next tick. */
+static volatile uint8_t idle;
+#endif /* CLOCK_CONF_TICKLESS */
+
 /* Make sure the CLOCK_CONF_SECOND is a power of two, to ensure
   that the modulo operation below becomes a logical and and not
   an expensive divide. Algorithm from Wikipedia:
@@ -63,12 +74,91 @@ static volatile uint16_t last_tar = 0;
 #error Change CLOCK_CONF_SECOND in contiki-conf.h.
 #endif
 
+/*---------------------------------------------------------------------------*/
+static uint16_t
+read_tar(void)
+{
+  uint16_t t1, t2;
+  do {
+    t1 = TAR;
+    t2 = TAR;
+  } while(t1 != t2);
+  return t1;
+}
+/*---------------------------------------------------------------------------*/
+/* Count the ticks that have passed since last_tar; there is more than one
+   after a tickless sleep or when the interrupt was held up. Called with
+   interrupts masked. */
+static void
+update_count(void)
+{
+  uint16_t now;
+
+  now = read_tar();
+  while((uint16_t)(now - last_tar) >= INTERVAL) {
+    last_tar += INTERVAL;
+    ++count;
+    if(count % CLOCK_CONF_SECOND == 0) {
+      ++seconds;
+    }
+  }
+}
+/*---------------------------------------------------------------------------*/
+#if CLOCK_CONF_TICKLESS
+/* Program the compare register for the earliest etimer deadline, or for
+   MAX_IDLE_TICKS ahead if that is sooner. Called with interrupts masked,
+   right after update_count(). */
+static void
+schedule_wakeup(void)
+{
+  clock_time_t ticks, left;
+
+  ticks = MAX_IDLE_TICKS;
+  if(etimer_pending()) {
+    left = etimer_next_expiration_time() - count;
+    if(left - 1 > MAX_TICKS) {
+      /* already expired */
+      ticks = 1;
+    } else if(left < ticks) {
+      ticks = left;
+    }
+  }
+  TACCR0 = last_tar + (uint16_t)ticks * INTERVAL;
+}
+/*---------------------------------------------------------------------------*/
+void
+clock_idle_enter(void)
+{
+  int s;
+
+  s = splhigh();
+  update_count();
+  idle = 1;
+  schedule_wakeup();
+  splx(s);
+}
+/*---------------------------------------------------------------------------*/
+void
+clock_idle_exit(void)
+{
+  int s;
+
+  s = splhigh();
+  if(idle) {
+    idle = 0;
+    update_count();
+    TACCR0 = last_tar + INTERVAL;
+  }
+  splx(s);
+}
+#endif /* CLOCK_CONF_TICKLESS */
 /*---------------------------------------------------------------------------*/
 void
 clock_set(clock_time_t clock, clock_time_t fclock)
 {
   TAR = fclock;
   TACCR0 = fclock + INTERVAL;
+  last_tar = fclock;
   count = clock;
 }
 /*---------------------------------------------------------------------------*/
@@ -93,42 +183,59 @@ clock_fine(void)
 clock_time_t
 clock_time(void)
 {
+#if CLOCK_CONF_TICKLESS
+  /* count lags behind while the CPU is idle; an interrupt handler woken
+     in the middle of a sleep must still see the right time */
+  clock_time_t t;
+  int s;
+
+  s = splhigh();
+  update_count();
+  t = count;
+  splx(s);
+  return t;
+#else /* CLOCK_CONF_TICKLESS */
   clock_time_t t1, t2;
   do {
     t1 = count;
     t2 = count;
   } while(t1 != t2);
   return t1;
+#endif /* CLOCK_CONF_TICKLESS */
 }
 /*---------------------------------------------------------------------------*/
 
 ISR(TIMER0_A0, timera0_interrupt)
 {
-  /* update the timer */
+  uint8_t wake = 0;
+
   TACCTL0 &= ~CCIFG;
-  TACCR0 += INTERVAL;
 
   watchdog_start();
 
-  /* update system time/clock */
-  do {
-    ++count;
-    if(count % CLOCK_CONF_SECOND == 0) {
-      ++seconds;
-    }
-  } while((TACCR0 - TAR) > INTERVAL);
-
-  /* remember last counter value */
-  last_tar = TAR;
+  /* update system time/clock and the timer */
+  update_count();
+  TACCR0 = last_tar + INTERVAL;
 
   /* check if any etimer is expired - wake up if so */
   if(etimer_pending() && (etimer_next_expiration_time() - count - 1) > MAX_TICKS) {
     etimer_request_poll();
-    LPM4_EXIT;
+    wake = 1;
   }
 
   /* check for pending process events - wake up if so */
-  if(process_nevents() >= 0) {
+  if(process_nevents() > 0) {
+    wake = 1;
+  }
+
+#if CLOCK_CONF_TICKLESS
+  /* nothing to do yet; go back to sleep until the next deadline */
+  if(idle && !wake) {
+    schedule_wakeup();
+  }
+#endif /* CLOCK_CONF_TICKLESS */
+
+  if(wake) {
     LPM4_EXIT;
   }
 
@@ -147,6 +254,7 @@ clock_init(void)
   TACCTL0 = CCIE;
   TACTL |= MC_2;
   count = 0;
+  last_tar = 0;
 
   eint();
 }
@@ -187,12 +295,23 @@ clock_set_seconds(unsigned long sec)
 unsigned long
 clock_seconds(void)
 {
+#if CLOCK_CONF_TICKLESS
+  unsigned long t;
+  int s;
+
+  s = splhigh();
+  update_count();
+  t = seconds;
+  splx(s);
+  return t;
+#else /* CLOCK_CONF_TICKLESS */
   unsigned long t1, t2;
   do {
     t1 = seconds;
     t2 = seconds;
   } while(t1 != t2);
   return t1;
+#endif /* CLOCK_CONF_TICKLESS */
 }
 /*---------------------------------------------------------------------------*/
 rtimer_clock_t
@@ -41,7 +41,7 @@
 #include "dev/uart0.h"
 #include "dev/watchdog.h"
 #include "sys/ctimer.h"
-#include "lib/ringbuf.h"
+#include "lib/ringbufblk.h"
 #include "isr_compat.h"
 
 static int (*uart0_input_handler)(unsigned char c);
@@ -77,8 +77,13 @@ putchar(int c)
   #else
   #define TXBUFSIZE 128
   #endif
-  static struct ringbuf txbuf;
+  #if (TXBUFSIZE & (TXBUFSIZE - 1)) != 0
+  #error TX_INTERRUPT_BUFSIZE_CONF must be a power of two
+  #endif
+  /* Filled by uart0_writeb(), emptied by the TX interrupt. */
+  static struct ringbufblk txbuf;
   static uint8_t txbuf_data[TXBUFSIZE];
+  static void (*tx_drained)(void);
 #endif /* TX_WITH_INTERRUPT */
 #endif /* _MCU_ */
 
@@ -87,12 +92,30 @@ uint8_t
 uart0_active(void)
 {
 #if _MCU_ == 2553
-  return (UCA0STAT & UCBBUSY) | rx_in_progress | transmitting;
+  return (UCA0STAT & UCBUSY) | rx_in_progress | transmitting;
 #else
   return 0;
 #endif /* _MCU_ */
 }
 /*---------------------------------------------------------------------------*/
+uint8_t
+uart0_tx_pending(void)
+{
+#if _MCU_ == 2553 && TX_WITH_INTERRUPT
+  return transmitting;
+#else
+  return 0;
+#endif /* _MCU_ && TX_WITH_INTERRUPT */
+}
+/*---------------------------------------------------------------------------*/
+void
+uart0_set_tx_drained(void (*callback)(void))
+{
+#if _MCU_ == 2553 && TX_WITH_INTERRUPT
+  tx_drained = callback;
+#endif /* _MCU_ && TX_WITH_INTERRUPT */
+}
+/*---------------------------------------------------------------------------*/
 void
 uart0_set_input(int (*input)(unsigned char c))
 {
@@ -107,18 +130,37 @@ uart0_writeb(unsigned char c)
 #if _MCU_ == 2553
   watchdog_periodic();
 #if TX_WITH_INTERRUPT
-  /* Put the outgoing byte on the transmission buffer. If the buffer
-     is full, we just keep on trying to put the byte into the buffer
-     until it is possible to put it there. */
-  while(ringbuf_put(&txbuf, c) == 0);
-
-  /* If there is no transmission going, we need to start it by putting
-     the first byte into the UART. */
-  if(transmitting == 0) {
-    transmitting = 1;
-    /* Loop until the transmission buffer is available. */
-    while((IFG2 & UTXIFG1) == 0);
-    TXBUF = ringbuf_get(&txbuf);
+  {
+    int s;
+
+    /* Put the outgoing byte on the transmission buffer. Interrupts are
+       masked while doing so, as an interrupt handler that prints would
+       otherwise be a second producer. If the buffer is full, the TX
+       interrupt makes room for it while interrupts are let through.
+       If they were masked by the caller, e.g. when printing from an
+       interrupt handler, we send the oldest byte ourselves; the
+       interrupt cannot run, so taking the consumer side here is
+       safe. */
+    s = splhigh();
+    while(ringbufblk_put(&txbuf, &c) == 0) {
+      if(s) {
+        splx(s);
+        s = splhigh();
+      } else {
+        uint8_t b;
+        while((IFG2 & UCA0TXIFG) == 0);
+        ringbufblk_get(&txbuf, &b);
+        TXBUF = b;
+      }
+    }
+
+    /* If there is no transmission going, enabling the TX interrupt
+       starts it, as the transmit buffer is empty. */
+    if(transmitting == 0) {
+      transmitting = 1;
+      IE2 |= UCA0TXIE;
+    }
+    splx(s);
   }
 
 #else /* TX_WITH_INTERRUPT */
@@ -164,8 +206,9 @@ uart0_init(unsigned long ubr)
   IE2 |= UCA0RXIFG;
 
   #if TX_WITH_INTERRUPT
-  ringbuf_init(&txbuf, txbuf_data, sizeof(txbuf_data));
-  IE2 |= UCA0TXIFG;
+  ringbufblk_init(&txbuf, txbuf_data, 1, sizeof(txbuf_data));
+  /* The TX interrupt is enabled while there is something to send. */
+  IE2 &= ~UCA0TXIE;
   #endif /* TX_WITH_INTERRUPT */
 #endif /* _MCU_ */
 }
@@ -193,11 +236,22 @@ ISR(USCIAB0RX, uartA0B0_rx_interrupt)
 #if TX_WITH_INTERRUPT
 ISR(USCIAB0TX, uartA0B0_tx_interrupt)
 {
-  if(IFG2 & UCA0TXIFG) {
-    if(ringbuf_elements(&txbuf) == 0) {
-      transmitting = 0;
+  uint8_t c;
+
+  /* The vector is shared with USCI B0, which is used without
+     interrupts. */
+  if((IFG2 & UCA0TXIFG) && (IE2 & UCA0TXIE)) {
+    if(ringbufblk_get(&txbuf, &c)) {
+      TXBUF = c;
     } else {
-      TXBUF = ringbuf_get(&txbuf);
+      /* The last byte is in the shift register; wake up the main loop
+         so that it can sleep deeper once that is out. */
+      IE2 &= ~UCA0TXIE;
+      transmitting = 0;
+      if(tx_drained != NULL) {
+        tx_drained();
+      }
+      LPM4_EXIT;
     }
   }
 }
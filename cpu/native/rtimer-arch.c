@@ -55,6 +55,45 @@
 #define PRINTF(...)
 #endif
 
+#if CLOCK_CONF_VIRTUAL
+/* The main loop runs the rtimer when the virtual clock reaches it. */
+static clock_time_t deadline;
+static int scheduled;
+/*---------------------------------------------------------------------------*/
+void
+rtimer_arch_init(void)
+{
+}
+/*---------------------------------------------------------------------------*/
+void
+rtimer_arch_schedule(rtimer_clock_t t)
+{
+  clock_time_t now;
+
+  now = clock_time();
+  deadline = now + (rtimer_clock_t)(t - (rtimer_clock_t)now);
+  scheduled = 1;
+}
+/*---------------------------------------------------------------------------*/
+int
+rtimer_arch_next(clock_time_t *t)
+{
+  if(scheduled) {
+    *t = deadline;
+  }
+  return scheduled;
+}
+/*---------------------------------------------------------------------------*/
+void
+rtimer_arch_run_due(void)
+{
+  if(scheduled && (long)(clock_time() - deadline) >= 0) {
+    scheduled = 0;
+    rtimer_run_next();
+  }
+}
+/*---------------------------------------------------------------------------*/
+#else /* CLOCK_CONF_VIRTUAL */
 /*---------------------------------------------------------------------------*/
 static void
 interrupt(int sig)
@@ -91,3 +130,4 @@ rtimer_arch_schedule(rtimer_clock_t t)
 #endif /* !_WIN32 */
 }
 /*---------------------------------------------------------------------------*/
+#endif /* CLOCK_CONF_VIRTUAL */
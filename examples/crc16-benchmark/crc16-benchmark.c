@@ -0,0 +1,86 @@
+/*
+ * Copyright (c) 2013, Swedish Institute of Computer Science.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the Institute nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE INSTITUTE AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE INSTITUTE OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ *
+ * This file is part of the Contiki operating system.
+ *
+ */
+
+/**
+ * \file
+ *         Measure the throughput of the configured CRC16 implementation
+ */
+
+#include "contiki.h"
+#include "lib/crc16.h"
+#include "lib/random.h"
+
+#include <stdio.h>
+/*---------------------------------------------------------------------------*/
+#define BLOCK_SIZE 1024
+#define BYTES      (64L * 1024 * 1024)
+
+static unsigned char block[BLOCK_SIZE];
+
+static const char *names[] = { "shift", "nibble", "table", "slice8" };
+
+PROCESS(crc16_benchmark_process, "CRC16 benchmark");
+AUTOSTART_PROCESSES(&crc16_benchmark_process);
+/*---------------------------------------------------------------------------*/
+PROCESS_THREAD(crc16_benchmark_process, ev, data)
+{
+  clock_time_t start, elapsed;
+  unsigned short crc;
+  long done;
+  int i;
+
+  PROCESS_BEGIN();
+
+  /* The standard check value of this CRC over "123456789" is 0x2189. */
+  crc = crc16_data((const unsigned char *)"123456789", 9, 0);
+  printf("crc16 %s: check value 0x%04x (%s)\n", names[CRC16_IMPL], crc,
+         crc == 0x2189 ? "ok" : "WRONG");
+
+  for(i = 0; i < BLOCK_SIZE; i++) {
+    block[i] = random_rand();
+  }
+
+  crc = 0;
+  start = clock_time();
+  for(done = 0; done < BYTES; done += BLOCK_SIZE) {
+    crc = crc16_data(block, BLOCK_SIZE, crc);
+  }
+  elapsed = clock_time() - start;
+
+  printf("crc16 %s: %ld bytes in %lu ticks of 1/%d s, %lu kbytes/s (crc 0x%04x)\n",
+         names[CRC16_IMPL], BYTES, (unsigned long)elapsed, CLOCK_SECOND,
+         elapsed > 0 ? (unsigned long)(BYTES / 1024 * CLOCK_SECOND / elapsed) : 0,
+         crc);
+
+  PROCESS_END();
+}
+/*---------------------------------------------------------------------------*/
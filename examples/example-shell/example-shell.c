@@ -72,6 +72,7 @@ PROCESS_THREAD(example_shell_process, ev, data)
   /*shell_ping_init();*/ /* uIP ping */
   shell_power_init();
   /*shell_profile_init();*/
+  /*shell_proctrace_init();*/
   shell_ps_init();
   /*shell_reboot_init();*/
   shell_rime_debug_init();
@@ -0,0 +1,156 @@
+/*
+ * Copyright (c) 2013, Swedish Institute of Computer Science.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the Institute nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE INSTITUTE AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE INSTITUTE OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ *
+ * This file is part of the Contiki operating system.
+ *
+ *
+ */
+
+/**
+ * \file
+ *         Measure the accuracy and throughput of the fixed-point FFTs
+ */
+
+#include "contiki.h"
+#include "lib/ifft.h"
+#include "lib/random.h"
+
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+/*---------------------------------------------------------------------------*/
+#define MIN_SIZE   16
+#define TRANSFORMS 1000000L
+
+static int16_t input[2 * IFFT_MAX_SIZE];
+static int16_t output[2 * IFFT_MAX_SIZE];
+
+PROCESS(ifft_benchmark_process, "FFT benchmark");
+AUTOSTART_PROCESSES(&ifft_benchmark_process);
+/*---------------------------------------------------------------------------*/
+static void
+fill(uint16_t len, int16_t amplitude)
+{
+  uint16_t i;
+
+  for(i = 0; i < len; i++) {
+    input[i] = (int16_t)(random_rand() % (2 * (unsigned)amplitude + 1)) - amplitude;
+  }
+}
+/*---------------------------------------------------------------------------*/
+/* The signal-to-noise ratio, in dB, of the first bins of output[]
+   scaled by 2^exp, compared with a floating-point DFT of input[]. */
+static double
+snr(uint16_t n, int real, int exp)
+{
+  double signal, noise, a, re, im, dre, dim;
+  uint16_t i, k, bins;
+
+  signal = noise = 0;
+  bins = real ? n / 2 + 1 : n;
+  for(k = 0; k < bins; k++) {
+    re = im = 0;
+    for(i = 0; i < n; i++) {
+      a = -2 * M_PI * k * i / n;
+      if(real) {
+        re += input[i] * cos(a);
+        im += input[i] * sin(a);
+      } else {
+        re += input[2 * i] * cos(a) - input[2 * i + 1] * sin(a);
+        im += input[2 * i] * sin(a) + input[2 * i + 1] * cos(a);
+      }
+    }
+    if(real && k == 0) {
+      dre = output[0];
+      dim = 0;
+    } else if(real && k == n / 2) {
+      dre = output[1];
+      dim = 0;
+    } else {
+      dre = output[2 * k];
+      dim = output[2 * k + 1];
+    }
+    dre = ldexp(dre, exp) - re;
+    dim = ldexp(dim, exp) - im;
+    signal += re * re + im * im;
+    noise += dre * dre + dim * dim;
+  }
+  return noise > 0 ? 10 * log10(signal / noise) : 999;
+}
+/*---------------------------------------------------------------------------*/
+static void
+run(uint16_t n, int real)
+{
+  static const int16_t amplitudes[] = { 100, 32767 };
+  const char *name = real ? "ifft_real" : "ifft_complex";
+  uint16_t len = real ? n : 2 * n;
+  clock_time_t start, elapsed;
+  long done;
+  int i, exp;
+
+  for(i = 0; i < sizeof(amplitudes) / sizeof(amplitudes[0]); i++) {
+    fill(len, amplitudes[i]);
+    memcpy(output, input, len * sizeof(int16_t));
+    exp = real ? ifft_real(output, n) : ifft_complex(output, n);
+    printf("%s %4u: amplitude %5d, SNR %.1f dB\n", name, n,
+           amplitudes[i], snr(n, real, exp));
+  }
+
+  start = clock_time();
+  for(done = 0; done < TRANSFORMS * MIN_SIZE / n; done++) {
+    memcpy(output, input, len * sizeof(int16_t));
+    if(real) {
+      ifft_real(output, n);
+    } else {
+      ifft_complex(output, n);
+    }
+  }
+  elapsed = clock_time() - start;
+
+  printf("%s %4u: %ld transforms in %lu ticks of 1/%d s, %lu transforms/s\n",
+         name, n, done, (unsigned long)elapsed, CLOCK_SECOND,
+         elapsed > 0 ? (unsigned long)(done * CLOCK_SECOND / elapsed) : 0);
+}
+/*---------------------------------------------------------------------------*/
+PROCESS_THREAD(ifft_benchmark_process, ev, data)
+{
+  uint16_t n;
+
+  PROCESS_BEGIN();
+
+  printf("FFT with %s passes, up to %d points\n",
+         IFFT_RADIX4 ? "radix-4" : "radix-2", IFFT_MAX_SIZE);
+
+  for(n = MIN_SIZE; n <= IFFT_MAX_SIZE; n *= 2) {
+    run(n, 0);
+    run(n, 1);
+  }
+
+  PROCESS_END();
+}
+/*---------------------------------------------------------------------------*/
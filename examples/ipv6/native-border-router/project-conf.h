@@ -57,4 +57,9 @@
 /* used by wpcap (see /cpu/native/net/wpcap-drv.c) */
 #define SELECT_CALLBACK 1
 
+#ifdef linux
+/* wait for the tun and slip descriptors with epoll */
+#define SELECT_CONF_EPOLL 1
+#endif
+
 #endif /* __PROJECT_ROUTER_CONF_H__ */
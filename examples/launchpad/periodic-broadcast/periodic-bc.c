@@ -78,8 +78,10 @@
 #include "dev/button.h"
 #include "dev/cc2500.h"
 
-/* time between transmissions */
+/* time between transmissions, and how much later one may go out so that its
+  wakeup can be shared with other timers */
 #define TRANSMISSION_INTERVAL     (CLOCK_SECOND/4)
+#define TRANSMISSION_SLACK        (CLOCK_SECOND/16)
 
 /* Channels; any number from 129..65535 (0..128 are reserved) */
 #define BROADCAST_CH              2674
@@ -147,7 +149,7 @@ PROCESS_THREAD(hello_process, ev, data)
   cc2500_set_channel(10);
 
   while(1) {
-    etimer_set(&transmission_et, TRANSMISSION_INTERVAL);
+    etimer_set_slack(&transmission_et, TRANSMISSION_INTERVAL, TRANSMISSION_SLACK);
     PROCESS_WAIT_EVENT_UNTIL(etimer_expired(&transmission_et));
 
     if(rimeaddr_node_addr.u8[0] != 1) {
@@ -79,7 +79,8 @@ PROCESS_THREAD(adc_reading_process, ev, data)
   while(1) {
     /* read analog in A7, store the result in adcval and poll this process when done */
     adc_get_poll(A7, &adcval, PROCESS_CURRENT());
-    etimer_set(&et, CLOCK_SECOND/8);
+    /* the next sample may be taken a little late, to share a wakeup */
+    etimer_set_slack(&et, CLOCK_SECOND/8, CLOCK_SECOND/32);
     PROCESS_WAIT_EVENT_UNTIL(etimer_expired(&et));
   }
   PROCESS_END();
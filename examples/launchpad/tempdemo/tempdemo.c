@@ -89,7 +89,8 @@ PROCESS_THREAD(tempdemo_process, ev, data)
     led_pwmdc = (100 * (temp_avg - TEMP_MIN) / (TEMP_MAX - TEMP_MIN));
     pwm_on(0, LED_PIN, led_pwmdc);
 
-    etimer_set(&et, CLOCK_SECOND/8);
+    /* the sample may be taken a little late, to share a wakeup */
+    etimer_set_slack(&et, CLOCK_SECOND/8, CLOCK_SECOND/32);
     PROCESS_WAIT_EVENT_UNTIL(etimer_expired(&et));
   }
   PROCESS_END();
@@ -0,0 +1,109 @@
+/*
+ * Copyright (c) 2012, Swedish Institute of Computer Science.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the Institute nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE INSTITUTE AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE INSTITUTE OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ *
+ * This file is part of the Contiki operating system.
+ *
+ */
+
+/**
+ * \file
+ *         Append and drain long queues with LIST() and LIST_TAIL()
+ */
+
+#include "contiki.h"
+#include "lib/list.h"
+
+#include <stdio.h>
+/*---------------------------------------------------------------------------*/
+#define MAX_LENGTH 4096
+#define APPENDS    65536L
+
+struct item {
+  struct item *next;
+  int value;
+};
+
+static struct item items[MAX_LENGTH];
+
+LIST(plain);
+LIST_TAIL(tail);
+
+PROCESS(list_benchmark_process, "List benchmark");
+AUTOSTART_PROCESSES(&list_benchmark_process);
+/*---------------------------------------------------------------------------*/
+static clock_time_t
+run_plain(int length)
+{
+  clock_time_t start;
+  long rounds;
+  int i;
+
+  start = clock_time();
+  for(rounds = APPENDS / length; rounds > 0; rounds--) {
+    for(i = 0; i < length; i++) {
+      list_add(plain, &items[i]);
+    }
+    while(list_pop(plain) != NULL);
+  }
+  return clock_time() - start;
+}
+/*---------------------------------------------------------------------------*/
+static clock_time_t
+run_tail(int length)
+{
+  clock_time_t start;
+  long rounds;
+  int i;
+
+  start = clock_time();
+  for(rounds = APPENDS / length; rounds > 0; rounds--) {
+    for(i = 0; i < length; i++) {
+      list_tail_add(tail, &items[i]);
+    }
+    while(list_tail_pop(tail) != NULL);
+  }
+  return clock_time() - start;
+}
+/*---------------------------------------------------------------------------*/
+PROCESS_THREAD(list_benchmark_process, ev, data)
+{
+  int length;
+
+  PROCESS_BEGIN();
+
+  printf("%ld appends per queue length, times in ticks of 1/%d s\n",
+         APPENDS, CLOCK_SECOND);
+  for(length = 16; length <= MAX_LENGTH; length *= 4) {
+    printf("length %4d list_add %6lu list_tail_add %6lu\n", length,
+           (unsigned long)run_plain(length),
+           (unsigned long)run_tail(length));
+  }
+
+  PROCESS_END();
+}
+/*---------------------------------------------------------------------------*/
@@ -0,0 +1,97 @@
+/*
+ * Copyright (c) 2012, Swedish Institute of Computer Science.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the Institute nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE INSTITUTE AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE INSTITUTE OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ *
+ * This file is part of the Contiki operating system.
+ *
+ */
+
+/**
+ * \file
+ *         Measure process_run() with many processes and one poll per round
+ */
+
+#include "contiki.h"
+
+#include <stdio.h>
+/*---------------------------------------------------------------------------*/
+#define PROCESSES 64
+#define ROUNDS    (4L * 1024 * 1024)
+
+static struct process pollees[PROCESSES];
+static unsigned long polls;
+
+PROCESS(poll_benchmark_process, "Poll benchmark");
+AUTOSTART_PROCESSES(&poll_benchmark_process);
+/*---------------------------------------------------------------------------*/
+static
+PT_THREAD(pollee_thread(struct pt *pt, process_event_t ev, process_data_t data))
+{
+  PT_BEGIN(pt);
+
+  while(1) {
+    PT_YIELD(pt);
+    if(ev == PROCESS_EVENT_POLL) {
+      polls++;
+    }
+  }
+
+  PT_END(pt);
+}
+/*---------------------------------------------------------------------------*/
+PROCESS_THREAD(poll_benchmark_process, ev, data)
+{
+  clock_time_t start, elapsed;
+  long round;
+  int i;
+
+  PROCESS_BEGIN();
+
+  for(i = 0; i < PROCESSES; i++) {
+#if !PROCESS_CONF_NO_PROCESS_NAMES
+    pollees[i].name = "Pollee";
+#endif /* !PROCESS_CONF_NO_PROCESS_NAMES */
+    pollees[i].thread = pollee_thread;
+    process_start(&pollees[i], NULL);
+  }
+
+  /* Each round polls one process and dispatches the poll. */
+  start = clock_time();
+  for(round = 0; round < ROUNDS; round++) {
+    process_poll(&pollees[round % PROCESSES]);
+    process_run();
+  }
+  elapsed = clock_time() - start;
+
+  printf("poll list %s: %d processes, %lu polls in %lu ticks of 1/%d s, %lu ns per process_run()\n",
+         PROCESS_CONF_POLL_LIST ? "on" : "off", PROCESSES, polls,
+         (unsigned long)elapsed, CLOCK_SECOND,
+         (unsigned long)((double)elapsed * 1000000000 / CLOCK_SECOND / ROUNDS));
+
+  PROCESS_END();
+}
+/*---------------------------------------------------------------------------*/
@@ -66,6 +66,12 @@ int simRadioChannel = 26;
 
 static const void *pending_data;
 
+/* Asynchronous transmission: the callback is set while the packet is
+   in simOutDataBuffer, and is called once COOJA has taken it. */
+static radio_tx_callback_t tx_callback;
+static void *tx_ptr;
+static char tx_radiostate;
+
 PROCESS(cooja_radio_process, "cooja radio process");
 
 /*---------------------------------------------------------------------------*/
@@ -97,6 +103,11 @@ radio_signal_strength_current(void)
 static int
 radio_on(void)
 {
+  if(tx_callback != NULL) {
+    /* Sending; switch when done */
+    tx_radiostate = 1;
+    return 1;
+  }
   simRadioHWOn = 1;
   return 1;
 }
@@ -104,6 +115,11 @@ radio_on(void)
 static int
 radio_off(void)
 {
+  if(tx_callback != NULL) {
+    /* Sending; switch when done */
+    tx_radiostate = 0;
+    return 1;
+  }
   simRadioHWOn = 0;
   return 1;
 }
@@ -111,6 +127,14 @@ radio_off(void)
 static void
 doInterfaceActionsBeforeTick(void)
 {
+  if(tx_callback != NULL && simOutSize == 0) {
+    radio_tx_callback_t callback = tx_callback;
+
+    tx_callback = NULL;
+    simRadioHWOn = tx_radiostate;
+    callback(tx_ptr, RADIO_TX_OK);
+  }
+
   if(!simRadioHWOn) {
     simInSize = 0;
     return;
@@ -158,11 +182,17 @@ channel_clear(void)
   return 1;
 }
 /*---------------------------------------------------------------------------*/
+static void
+wait_tx(void)
+{
+  while(tx_callback != NULL) {
+    cooja_mt_yield();
+  }
+}
+/*---------------------------------------------------------------------------*/
 static int
-radio_send(const void *payload, unsigned short payload_len)
+start_send(const void *payload, unsigned short payload_len)
 {
-  int radiostate = simRadioHWOn;
-
   /* Simulate turnaround time of 1ms */
 #if WITH_TURNAROUND
   simProcessRunValue = 1;
@@ -193,6 +223,21 @@ radio_send(const void *payload, unsigned short payload_len)
   /* Copy packet data to temporary storage */
   memcpy(simOutDataBuffer, payload, payload_len);
   simOutSize = payload_len;
+  return RADIO_TX_OK;
+}
+/*---------------------------------------------------------------------------*/
+static int
+radio_send(const void *payload, unsigned short payload_len)
+{
+  int radiostate;
+  int ret;
+
+  wait_tx();
+  radiostate = simRadioHWOn;
+  ret = start_send(payload, payload_len);
+  if(ret != RADIO_TX_OK) {
+    return ret;
+  }
 
   /* Transmit */
   while(simOutSize > 0) {
@@ -221,6 +266,25 @@ transmit_packet(unsigned short len)
 }
 /*---------------------------------------------------------------------------*/
 static int
+transmit_packet_async(unsigned short len,
+                      radio_tx_callback_t callback, void *ptr)
+{
+  int ret = RADIO_TX_ERR;
+
+  wait_tx();
+  tx_radiostate = simRadioHWOn;
+  if(pending_data != NULL) {
+    ret = start_send(pending_data, len);
+  }
+  if(ret == RADIO_TX_OK) {
+    /* The packet has been copied, so the next one may be prepared. */
+    tx_ptr = ptr;
+    tx_callback = callback;
+  }
+  return ret;
+}
+/*---------------------------------------------------------------------------*/
+static int
 receiving_packet(void)
 {
   return simReceiving;
@@ -271,6 +335,7 @@ const struct radio_driver cooja_radio_driver =
     pending_packet,
     radio_on,
     radio_off,
+    transmit_packet_async,
 };
 /*---------------------------------------------------------------------------*/
 SIM_INTERFACE(radio_interface,
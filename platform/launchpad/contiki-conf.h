@@ -70,7 +70,7 @@
 // dev/serial-line.h
 #define SERIAL_LINE_CONF_BUFSIZE            32
 
-// g2xxxx/uart1.c; XXX until interrupt driven UART is done, these have no effect (and no RAM will be allocated either)
+// g2xxx/uart0.c; TX buffer, a power of two. The RX size has no effect.
 #define TX_INTERRUPT_BUFSIZE_CONF           32
 #define RX_INTERRUPT_BUFSIZE_CONF           32
 
@@ -80,10 +80,13 @@
 /* define the network and some related settings ------------------ */
 #ifndef NETSTACK_CONF_MAC
 #define NETSTACK_CONF_MAC     nullmac_driver
+//#define NETSTACK_CONF_MAC     csma_driver       /* queues, bursts w WOR-RDC */
 #endif /* NETSTACK_CONF_MAC */
 
 #ifndef NETSTACK_CONF_RDC
 #define NETSTACK_CONF_RDC     simplerdc_driver
+//#define NETSTACK_CONF_RDC     worrdc_driver     /* CC2500 Wake-on-Radio */
+//#define CSMA_CONF_BURST       1                 /* csma bursts, w WOR-RDC */
 //#define NETSTACK_CONF_RDC     nullrdc_driver
 #endif /* NETSTACK_CONF_RDC */
 
@@ -177,8 +180,23 @@ future use, compiler errors, and completeness */
 
 #define PROCESS_CONF_NUMEVENTS          8     /* each takes 8 B RAM */
 #define PROCESS_CONF_STATS              1     /* less: 18 B ROM, 0 RAM if set to 1 */
+#define PROCESS_CONF_PRIORITIES         2     /* radio and etimer events go first */
+#define PROCESS_CONF_POLL_LIST          1     /* 2 B RAM per process */
+#define PROCESS_CONF_POLL_LOCK(s)       ((s) = splhigh())
+#define PROCESS_CONF_POLL_UNLOCK(s)     splx(s)
+//#define PROCESS_CONF_SUBSCRIPTIONS    4     /* 4 B RAM each */
 //#define PROCESS_CONF_FASTPOLL         4
 
+#define ETIMER_CONF_SLACK               1     /* 4 B RAM per etimer and ctimer */
+
+#define RTIMER_CONF_QUEUE               1     /* 4 B RAM per rtimer */
+#define RTIMER_CONF_LOCK(s)             ((s) = splhigh())
+#define RTIMER_CONF_UNLOCK(s)           splx(s)
+
+//#define PROCTRACE_CONF_SIZE           16    /* 8 B RAM each */
+#define PROCTRACE_CONF_LOCK(s)          ((s) = splhigh())
+#define PROCTRACE_CONF_UNLOCK(s)        splx(s)
+
 
 //#define AODV_COMPLIANCE
 //#define AODV_NUM_RT_ENTRIES           32
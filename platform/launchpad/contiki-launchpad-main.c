@@ -101,6 +101,7 @@ main(void)
   rtimer_init();
   process_init();
   process_start(&etimer_process, NULL);
+  process_set_priority(&etimer_process, PROCESS_PRIORITY_HIGH);
   ctimer_init();
 
   button_init();
@@ -166,21 +167,41 @@ main(void)
       r = process_run();
     } while(r > 0);
 
-    /* if not printing or pending events, sleep. */
+    /* if not printing or pending events, sleep. Interrupts are masked
+       until the CPU sleeps, so an event posted after the check still wakes
+       us; otherwise it would wait for the next tick, or with a tickless
+       clock for the next etimer deadline. */
+    dint();
     #if USE_SERIAL
-      if(process_nevents() == 0 && !uart0_active()) {
-    #else
-      if(process_nevents() == 0) {
+      /* The UART is clocked from SMCLK, which is stopped in LPM3. While
+         the TX interrupt is emptying the buffer, sleep in LPM0; it wakes
+         us when done. Then wait for the last byte to be shifted out. */
+      if(process_nevents() == 0 && uart0_tx_pending()) {
+        __bis_SR_register(GIE | LPM0_bits);
+        continue;
+      }
+      if(process_nevents() == 0 && uart0_active()) {
+        eint();
+        while(uart0_active());
+        continue;
+      }
     #endif  /* USE_SERIAL */
+      if(process_nevents() == 0) {
+      #if CLOCK_CONF_TICKLESS
+        clock_idle_enter();
+      #endif  /* CLOCK_CONF_TICKLESS */
       /* we are ready to go to sleep, LPM3 */
       if(dcoreq == 0) {
-        LPM3;
+        __bis_SR_register(GIE | LPM3_bits);
       } else {
-        LPM0;
+        __bis_SR_register(GIE | LPM0_bits);
       }
       asm("NOP;");
-
+      #if CLOCK_CONF_TICKLESS
+        clock_idle_exit();
+      #endif  /* CLOCK_CONF_TICKLESS */
     }
+    eint();
   }
   return;
 }
@@ -170,8 +170,18 @@
 #define RXOFF_RX          (3<<2)    /* stay in Rx after received packet */
 #define TXOFF_IDLE        (0<<0)    /* goto IDLE after packet sent */
 #define TXOFF_RX          (3<<0)    /* goto Rx after packet sent */
+#define TXOFF_TX          (2<<0)    /* stay in Tx, sending preamble, after packet sent */
+#define TXOFF_MODE        (3<<0)    /* mask of the TXOFF bits */
 #define FS_AUTOCAL_NEVER  (0<<4)    /* only calibrate oscillator manually */
 #define PO_TIMEOUT_1      (1<<2)
+#define PO_TIMEOUT_2      (2<<2)
+#define FS_AUTOCAL_4TH    (3<<4)    /* calibrate every 4th time from IDLE to Rx/Tx */
+#define RX_TIME_RSSI      (1<<4)    /* WOR: end Rx early if no carrier sensed */
+#define RX_TIME_QUAL      (1<<3)    /* WOR: stay in Rx if sync word is found */
+#define WORCTRL_RC_CAL    (1<<3)    /* calibrate WOR RC oscillator automatically */
+#define WORCTRL_EVENT1(x) ((x)<<4)  /* xosc start-up time, 4..48 RC periods */
+#define PKTCTRL1_APPEND_STATUS (1<<2) /* append RSSI, LQI and CRC ok to frames */
+#define PKTCTRL1_ADR_CHK_BC0   (2<<0) /* accept frames to ADDR and to 0x00 */
 
 
 
@@ -44,16 +44,24 @@
 #include "dev/cc2500-const.h"
 #include "dev/cc2500-config.h"
 #include "dev/leds.h"
+#include "net/rime/rimestats.h"
 /*#include "sys/timetable.h"*/
 
 /*---------------------------------------------------------------------------*/
 /* conf defines */
 /*#define WITH_SEND_CCA 1*/
 
-/* let the radio do destination address filtering in hardware, will conserve
-  power when used with SimpleRDC as unicasts will be ACKed immediately, letting
-  the sender go to sleep and we can use shorter wake-up periods on all nodes. */
+/* let the radio do destination address filtering in hardware. The first byte
+  of every frame is the first byte of the receiver address (see framer-nullmac),
+  which the radio compares with ADDR and with 0x00 for broadcasts. Frames for
+  other nodes are then never put in the RxFIFO, and are not read over SPI. The
+  second address byte is still checked in software by the RDC layer. NB nodes
+  whose first address byte is 0 receive all traffic. */
+#ifdef CC2500_CONF_ADDRESS_FILTER
+#define USE_HW_ADDRESS_FILTER     CC2500_CONF_ADDRESS_FILTER
+#else
 #define USE_HW_ADDRESS_FILTER     1
+#endif
 
 
 /*---------------------------------------------------------------------------*/
@@ -143,11 +151,15 @@
 int         cc2500_init(void);
 static int  cc2500_prepare(const void *data, unsigned short len);
 static int  cc2500_transmit(unsigned short len);
+static int  cc2500_transmit_async(unsigned short len,
+                                  radio_tx_callback_t callback, void *ptr);
 /*static int  cc2500_send(const void *data, unsigned short len);*/
 static int  cc2500_read(void *buf, unsigned short bufsize);
 static int  cc2500_cca(void);
 static int  cc2500_receiving_packet(void);
 static int  cc2500_pending_packet(void);
+static int  read_frame(void *buf, unsigned short bufsize);
+static uint8_t fifo_bytes(uint8_t reg);
 int         cc2500_on(void);
 int         cc2500_off(void);
 
@@ -191,6 +203,9 @@ const struct radio_driver cc2500_driver =
 
   /** Turn the radio off. */
   cc2500_off,
+
+  /** Send the prepared packet, call back from the ISR when it is sent. */
+  cc2500_transmit_async,
 };
 
 /* function prototypes for helper functions--------------- */
@@ -222,9 +237,25 @@ static uint8_t is_on = 0;         // XXX remove later
 static uint8_t should_off = 0;    // XXX remove later
 static uint8_t is_state = CC2500_STATE_IDLE;    /* current state */
 static uint8_t goto_state = CC2500_STATE_IDLE;  /* state to go to when eg tx is done */
+
+/* Wake-on-Radio; when sniffing, the radio is not put in IDLE when turned off
+  but in WOR, where it sleeps and wakes up on its own to listen for a while (see
+  cc2500_set_sniff()). Any SPI access wakes the chip up again and ends WOR. */
+static uint8_t sniff = 0;
+
+/* Asynchronous transmission; the callback is set while a frame is being sent
+  and is cleared by the ISR at its end-of-packet interrupt. */
+static radio_tx_callback_t volatile tx_callback = NULL;
+static void *tx_ptr;
+
+/* Sending frames back to back; the radio stays in Tx between them (see
+  cc2500_set_tx_repeat()). txoff_mode is the MCSM1.TXOFF_MODE to restore. */
+static uint8_t tx_repeat = 0;
+static uint8_t txoff_mode;
 /*--------------------------------------------------------------------------*/
 /* the length of rssi, checksum etc bytes appended by radio to packet */
 #define FOOTER_LEN        2   // after the packet, two bytes RSSI+LQI+CRC are appended
+#define TXFIFO_SIZE       64
 
 #define CC2500_DEFAULT_CONFIG_LEN    47
 extern const uint8_t cc2500_default_config[];
@@ -232,10 +263,32 @@ extern const uint8_t cc2500_txp[];
 /*---------------------------------------------------------------------------*/
 PROCESS(cc2500_process, "CC2500 driver");
 /*---------------------------------------------------------------------------*/
+/* pulling CSn low wakes the radio from SLEEP; wait until it is ready for SPI */
+static void
+wake(void)
+{
+  CC2500_SPI_ENABLE();
+  BUSYWAIT_UNTIL((SPI_PORT(IN) & SPI_MISO) == 0, RTIMER_SECOND / 1000);
+  CC2500_SPI_DISABLE();
+}
+/*---------------------------------------------------------------------------*/
+/* let the radio sleep and listen for traffic on its own */
+static void
+wor(void)
+{
+  cc2500_strobe(CC2500_SIDLE);
+  cc2500_strobe(CC2500_SFRX);
+  cc2500_strobe(CC2500_SWORRST);
+  cc2500_strobe(CC2500_SWOR);
+}
+/*---------------------------------------------------------------------------*/
 /* turn on radio */
 static void
 on(void)
 {
+  if(sniff) {
+    wake();
+  }
   cc2500_strobe(CC2500_SRX);
   BUSYWAIT_UNTIL(CC2500_STATUS() == CC2500_STATE_RX, RTIMER_SECOND / 100);
   is_on = 1;
@@ -250,8 +303,12 @@ off(void)
   BUSYWAIT_UNTIL((CC2500_GDO_PORT(IN) & CC2500_GDO_PIN) == 0, RTIMER_SECOND / 100);
 
   /* might not have finished transmitting here if something is wrong, so we
-   * command it into IDLE anyway. */
-  cc2500_strobe(CC2500_SIDLE);
+   * command it into IDLE (or WOR) anyway. */
+  if(sniff) {
+    wor();
+  } else {
+    cc2500_strobe(CC2500_SIDLE);
+  }
   is_on = 0;
 }
 /*---------------------------------------------------------------------------*/
@@ -282,8 +339,8 @@ cc2500_reset(void)
 
 #if USE_HW_ADDRESS_FILTER
   /* write node address and address filter on (ADDR, broadcast 0x00) */
-  cc2500_write_single(CC2500_ADDR, rimeaddr_node_addr.u8[0]);
-  cc2500_write_single(CC2500_PKTCTRL1, 0x06);
+  cc2500_set_address(rimeaddr_node_addr.u8[0]);
+  cc2500_write_single(CC2500_PKTCTRL1, PKTCTRL1_APPEND_STATUS | PKTCTRL1_ADR_CHK_BC0);
 #endif /* USE_HW_ADDRESS_FILTER */
 
   /* start in rx mode */
@@ -303,11 +360,32 @@ cc2500_init(void)
 
   /* start process that will handle interrupts */
   process_start(&cc2500_process, NULL);
+  process_set_priority(&cc2500_process, PROCESS_PRIORITY_HIGH);
   return 1;
 }
 /*---------------------------------------------------------------------------*/
-static int
-cc2500_transmit(unsigned short payload_len)
+/* Wait for an asynchronous transmission to end. Should its interrupt never
+  come, the transmission is given up and reported as failed. */
+static void
+wait_tx(void)
+{
+  radio_tx_callback_t callback;
+  int s;
+
+  BUSYWAIT_UNTIL(tx_callback == NULL, RTIMER_SECOND / 100);
+  s = splhigh();
+  callback = tx_callback;
+  tx_callback = NULL;
+  splx(s);
+  if(callback != NULL) {
+    callback(tx_ptr, RADIO_TX_ERR);
+  }
+}
+/*---------------------------------------------------------------------------*/
+/* start sending what is in the TxFIFO; returns 0 if the radio did not go into
+  Tx, ie when it was receiving or the channel was busy */
+static uint8_t
+start_tx(void)
 {
   /* set txp according to the packetbuf attribute */
   if(packetbuf_attr(PACKETBUF_ATTR_RADIO_TXPOWER) > 0) {
@@ -322,11 +400,67 @@ cc2500_transmit(unsigned short payload_len)
 /*    BUSYWAIT_UNTIL(CC2500_STATUS() == CC2500_STATE_RX, RTIMER_SECOND / 100);*/
 /*  }*/
 
-  /* transmit: strobe Tx, then wait until transmitting, then wait till done */
+  /* strobe Tx, then wait until transmitting */
   cc2500_strobe(CC2500_STX);
   BUSYWAIT_UNTIL(CC2500_STATUS() == CC2500_STATE_TX, RTIMER_SECOND / 100);
+  return CC2500_STATUS() == CC2500_STATE_TX;
+}
+/*---------------------------------------------------------------------------*/
+static int
+cc2500_transmit(unsigned short payload_len)
+{
+  wait_tx();
+  if(!tx_repeat || CC2500_STATUS() != CC2500_STATE_TX) {
+    if(!start_tx()) {
+      return RADIO_TX_COLLISION;
+    }
+  }
+
+  if(tx_repeat) {
+    /* The radio stays in Tx after the frame, so wait for the frame itself:
+      until the TxFIFO has been emptied and then the end-of-packet. */
+    BUSYWAIT_UNTIL(fifo_bytes(CC2500_TXBYTES) == 0, RTIMER_SECOND / 100);
+    BUSYWAIT_UNTIL((CC2500_GDO_PORT(IN) & CC2500_GDO_PIN) == 0, RTIMER_SECOND / 100);
+    return CC2500_STATUS() == CC2500_STATE_TX ? RADIO_TX_OK : RADIO_TX_ERR;
+  }
+
+  /* wait till done */
   BUSYWAIT_UNTIL((CC2500_STATUS() != CC2500_STATE_TX), RTIMER_SECOND / 100);
-  return 1;
+  return RADIO_TX_OK;
+}
+/*---------------------------------------------------------------------------*/
+static int
+cc2500_transmit_async(unsigned short payload_len,
+                      radio_tx_callback_t callback, void *ptr)
+{
+  int s;
+
+  wait_tx();
+  if(tx_repeat && CC2500_STATUS() == CC2500_STATE_TX) {
+    /* The frame was queued behind the previous one and went out right after
+      it, so it may have been sent already, its interrupt with no callback. */
+    tx_ptr = ptr;
+    tx_callback = callback;
+    s = splhigh();
+    if(tx_callback != NULL && fifo_bytes(CC2500_TXBYTES) == 0 &&
+       (CC2500_GDO_PORT(IN) & CC2500_GDO_PIN) == 0) {
+      tx_callback = NULL;
+      splx(s);
+      callback(ptr, RADIO_TX_OK);
+    } else {
+      splx(s);
+    }
+    return RADIO_TX_OK;
+  }
+  if(!start_tx()) {
+    return RADIO_TX_COLLISION;
+  }
+
+  /* The radio is in Tx, so the end-of-packet interrupt is still at least a
+    preamble and sync word away, and this is in time for it. */
+  tx_ptr = ptr;
+  tx_callback = callback;
+  return RADIO_TX_OK;
 }
 /*---------------------------------------------------------------------------*/
 static int
@@ -334,14 +468,23 @@ cc2500_prepare(const void *payload, unsigned short payload_len)
 {
   /* Write packet to TX FIFO after flushing it. First byte is total length
     (hdr+data), not including the lenght byte. */
-  cc2500_strobe(CC2500_SIDLE);
-  cc2500_strobe(CC2500_SFTX);
+  if(sniff) {
+    wake();
+  }
+
+  /* If a frame is being sent asynchronously, queue this one behind it in the
+    TxFIFO instead, as flushing would cut the first one short. */
+  if(tx_callback != NULL &&
+     fifo_bytes(CC2500_TXBYTES) + 1 + payload_len > TXFIFO_SIZE) {
+    wait_tx();
+  }
+  if(tx_callback == NULL &&
+     !(tx_repeat && CC2500_STATUS() == CC2500_STATE_TX)) {
+    cc2500_strobe(CC2500_SIDLE);
+    cc2500_strobe(CC2500_SFTX);
+  }
 
   cc2500_write_burst(CC2500_TXFIFO, &payload_len, 1);
-#if USE_HW_ADDRESS_FILTER
-  /* write destination address high byte */
-  //cc2500_write_burst(CC2500_TXFIFO, &payload_len, 1);
-#endif /* USE_HW_ADDRESS_FILTER */
   cc2500_write_burst(CC2500_TXFIFO, (uint8_t*) payload, payload_len);
   return 0;
 }
@@ -388,6 +531,10 @@ cc2500_on(void)
 void
 cc2500_set_channel(uint8_t c)
 {
+  if(sniff) {
+    wake();
+  }
+
   /* Wait for any ev transmission to end and any receiving to end. */
   BUSYWAIT_UNTIL(CC2500_STATUS() != CC2500_STATE_TX, RTIMER_SECOND / 100);
   BUSYWAIT_UNTIL((CC2500_GDO_PORT(IN) & CC2500_GDO_PIN) == 0, RTIMER_SECOND / 100);
@@ -413,201 +560,315 @@ cc2500_set_channel(uint8_t c)
   return;
 }
 /*---------------------------------------------------------------------------*/
+/* set the address the radio filters received frames on, if address filtering
+  is used; call again if the node address changes. */
+void
+cc2500_set_address(uint8_t addr)
+{
+#if USE_HW_ADDRESS_FILTER
+  if(sniff && !is_on) {
+    wake();
+    cc2500_write_single(CC2500_ADDR, addr);
+    wor();
+  } else {
+    cc2500_write_single(CC2500_ADDR, addr);
+  }
+#endif /* USE_HW_ADDRESS_FILTER */
+}
+/*---------------------------------------------------------------------------*/
+/* Turn Wake-on-Radio on or off. The WOR timing (WOREVT1/0, WORCTRL, MCSM2) is
+  left to the caller to set up. With sniffing on, cc2500_off() puts the radio in
+  WOR, and it goes back to WOR after it has received a frame while off. */
+void
+cc2500_set_sniff(uint8_t enable)
+{
+  if(enable == sniff) {
+    return;
+  }
+  if(!is_on) {
+    if(enable) {
+      sniff = 1;
+      wor();
+    } else {
+      /* out of WOR and into IDLE, ie plain off */
+      wake();
+      cc2500_strobe(CC2500_SIDLE);
+      sniff = 0;
+    }
+  } else {
+    sniff = enable;
+  }
+}
+/*---------------------------------------------------------------------------*/
+/* Send frames back to back. With this on, the radio stays in Tx after a frame
+  and sends preamble until the next one is written to the TxFIFO, so there is
+  no IDLE, TxFIFO flush or calibration between them. The oscillator is
+  calibrated once here instead, and the radio is left in IDLE for the first
+  transmission. Turn it off again before cc2500_off(), which would otherwise
+  wait for the Tx to end; the radio is then put back in Rx or off. Nothing can
+  be received in between, so this is not for frames that expect an ACK. */
+void
+cc2500_set_tx_repeat(uint8_t enable)
+{
+  uint8_t mcsm1;
+
+  if(enable == tx_repeat) {
+    return;
+  }
+  if(sniff) {
+    wake();
+  }
+  wait_tx();
+  BUSYWAIT_UNTIL((CC2500_GDO_PORT(IN) & CC2500_GDO_PIN) == 0, RTIMER_SECOND / 100);
+  cc2500_strobe(CC2500_SIDLE);
+
+  mcsm1 = cc2500_read_single(CC2500_MCSM1);
+  if(enable) {
+    txoff_mode = mcsm1 & TXOFF_MODE;
+    cc2500_write_single(CC2500_MCSM1, (mcsm1 & ~TXOFF_MODE) | TXOFF_TX);
+    cc2500_strobe(CC2500_SCAL);
+    BUSYWAIT_UNTIL(CC2500_STATUS() == CC2500_STATE_IDLE, RTIMER_SECOND / 100);
+    tx_repeat = 1;
+  } else {
+    cc2500_strobe(CC2500_SFTX);
+    cc2500_write_single(CC2500_MCSM1, (mcsm1 & ~TXOFF_MODE) | txoff_mode);
+    tx_repeat = 0;
+    if(is_on) {
+      on();
+    } else {
+      off();
+    }
+  }
+}
+/*---------------------------------------------------------------------------*/
+/* Receive bookkeeping. The ISR counts end-of-packet interrupts in rx_eop and
+  stores the time of each, the driver process consumes them in rx_eop_read as
+  it reads the frames out of the RxFIFO. Only the ISR writes rx_eop and only
+  the process writes rx_eop_read, so they need no locking. The radio also
+  signals end-of-packet after our own transmissions, so the two are brought in
+  sync again every time the RxFIFO is found empty. */
+#define RX_TIMESTAMPS     4   /* must be a power of two */
+static volatile uint8_t rx_eop = 0;
+static uint8_t rx_eop_read = 0;
+static rtimer_clock_t rx_timestamps[RX_TIMESTAMPS];
+
+/* length of a frame that has been started on but is still being received */
+static uint8_t rx_len = 0;
+/*---------------------------------------------------------------------------*/
 /* this is called from the interrupt service routine; polls the radio process
   which in turn reads the packet from the radio when it runs. The reason for 
   this is to avoid blocking the radio from the ISR. */
-volatile uint8_t pending_rxfifo = 0;  // XXX
 int
 cc2500_interrupt(void)
 {
-  pending_rxfifo++;
+  radio_tx_callback_t callback = tx_callback;
+
+  /* the end of a frame we are sending asynchronously */
+  if(callback != NULL) {
+    tx_callback = NULL;
+    callback(tx_ptr, RADIO_TX_OK);
+  }
+
+  rx_timestamps[rx_eop & (RX_TIMESTAMPS - 1)] = RTIMER_NOW();
+  rx_eop++;
   process_poll(&cc2500_process);
   return 1;
 }
 /*---------------------------------------------------------------------------*/
-/*static struct timer radio_check_timer;*/
 PROCESS_THREAD(cc2500_process, ev, data)
 {
   PROCESS_POLLHANDLER();
   PROCESS_EXITHANDLER();
   PROCESS_BEGIN();
-  
-/*  timer_set(&radio_check_timer, CLOCK_SECOND);*/
+
   while(1) {
     PROCESS_YIELD_UNTIL(ev == PROCESS_EVENT_POLL);
-/*    PROCESS_YIELD_UNTIL(ev == PROCESS_EVENT_POLL || timer_expired(&radio_check_timer));*/
-/*    if(timer_expired(&radio_check_timer)) {*/
-      /*
-       * periodically check the radio for error states and if so reset the radio.
-       * This takes ca 8 bytes RAM and 100 bytes ROM so if necessary, remove.
-       */
-/*      uint8_t state = CC2500_STATUS();*/
-/*      if(state == CC2500_STATE_RXFIFO_OVERFLOW || state == CC2500_STATE_TXFIFO_UNDERFLOW) {*/
-/*        cc2500_reset();*/
-/*      }*/
-/*      timer_reset(&radio_check_timer);*/
-/*    } else {*/
-
-      /* We end up here after a radio GDO port ISR -> interrupt handler -> poll process */
-      static uint8_t len = 0;
-      PRINTF("CC2500 polled\n");
-      pending_rxfifo--;
-
-      cc2500_read_burst(CC2500_RXBYTES, &len, 1);
+    {
+      uint8_t frames;
+      int len;
 
-      /* overflow in RxFIFO, drop all */
-      if(len & 0x80) {
-        FLUSH_FIFOS();
-        PRINTF("Overflow;F\n");
-
-      } else if(len > 0) {
-        /* prepare packetbuffer: clear it and set any attributes eg timestamp */
+      /* We end up here after a radio GDO port ISR -> interrupt handler -> poll
+        process. Read out every complete frame before yielding, as frames that
+        arrive back-to-back would otherwise be left to overflow the RxFIFO. */
+      PRINTF("CC2500 polled\n");
+      frames = 0;
+      while(1) {
+        /* prepare packetbuffer: clear it, the read sets the attributes */
         packetbuf_clear();
-        //packetbuf_set_attr(PACKETBUF_ATTR_TIMESTAMP, last_packet_timestamp);
-
-        /* read length of packet (first FIFO byte) then pass to higher layers */
-        len = cc2500_read(packetbuf_dataptr(), PACKETBUF_SIZE);
-        if(len > 0) {
+        len = read_frame(packetbuf_dataptr(), PACKETBUF_SIZE);
+        if(len == 0) {
+          break;
+        } else if(len > 0) {
           packetbuf_set_datalen(len);
+          frames++;
           NETSTACK_RDC.input();
-          /* re-poll the radio process so it can check for any packet received while
-          we were handling this one (it will check the rxfifo for data). */
-/*          cc2500_interrupt();*/
         } else {
-          /* no received data or bad data that was dropped. Do nothing. */
+          /* bad frame that was dropped, go on with the next one */
         }
       }
 
-    //XXX
-/*    }*/
+      if(frames > 0) {
+        RIMESTATS_ADD(llrxpolls);
+        RIMESTATS_MAX(llrxburst, frames);
+      }
+
+      /* if the radio woke up on its own to receive this, let it sleep again */
+      if(sniff && !is_on && !cc2500_pending_packet() &&
+         !(CC2500_GDO_PORT(IN) & CC2500_GDO_PIN)) {
+        wor();
+      }
+    }
   }
   PROCESS_END();
 }
 /*---------------------------------------------------------------------------*/
-static int
-cc2500_read(void *buf, unsigned short bufsize)
+/* Read the number of bytes in the RxFIFO or TxFIFO (reg is CC2500_RXBYTES or
+  CC2500_TXBYTES), with bit 7 set on overflow/underflow. The register may be
+  read while it is being updated, so read until two readings agree (see the
+  CC2500 errata). */
+static uint8_t
+fifo_bytes(uint8_t reg)
 {
-  uint8_t footer[2];
-  uint8_t len, dest;
-
-  PRINTF("CC2500:r\n");
+  uint8_t a, b;
+
+  b = cc2500_read_single(reg);
+  do {
+    a = b;
+    b = cc2500_read_single(reg);
+  } while(a != b);
+  return a;
+}
+/*---------------------------------------------------------------------------*/
+/* drop everything in the RxFIFO, eg after an overflow or a corrupt length */
+static void
+flush_rx(void)
+{
+  FLUSH_FIFOS();
+  rx_len = 0;
+  rx_eop_read = rx_eop;
+}
+/*---------------------------------------------------------------------------*/
+/* the time of the end-of-packet interrupt of the frame being read */
+static rtimer_clock_t
+rx_timestamp(void)
+{
+  uint8_t eop = rx_eop;
 
-  if(pending_rxfifo == 0) {
-    /* we don't have anything in the FIFO (ie no interrupt has fired) */
-    return 0;
+  if(eop == rx_eop_read) {
+    /* the interrupt for this frame has not been serviced yet */
+    return RTIMER_NOW();
+  }
+  if((uint8_t)(eop - rx_eop_read) > RX_TIMESTAMPS) {
+    /* the oldest timestamps have been overwritten, skip them */
+    rx_eop_read = eop - RX_TIMESTAMPS;
   }
+  return rx_timestamps[rx_eop_read++ & (RX_TIMESTAMPS - 1)];
+}
+/*---------------------------------------------------------------------------*/
+/* Read one frame from the RxFIFO. Returns the length of the frame, 0 if there
+  is no complete frame in the FIFO, or -1 if a bad frame was dropped. */
+static int
+read_frame(void *buf, unsigned short bufsize)
+{
+  uint8_t footer[FOOTER_LEN];
+  uint8_t avail, len;
+  rtimer_clock_t timestamp;
 
-#if 0
-  /* do an early check for FIFO overflow */
-  cc2500_read_burst(CC2500_RXBYTES, &len, 1);
-  if(len & 0x80) {
+  avail = fifo_bytes(CC2500_RXBYTES);
+  if(avail & 0x80) {
     /* overflow in RxFIFO, drop all */
-    FLUSH_FIFOS();
+    flush_rx();
+    RIMESTATS_ADD(llrxoverflow);
     PRINTF("Overflow;F\n");
     return 0;
-  } else if(len == 0) {
-    /* nothing in buffer */
-    return 0;
   }
-#endif /* if 0; commented out code */
-
-  /* first byte in FIFO is length of the packet with no appended footer */
-  cc2500_read_burst(CC2500_RXFIFO, &len, 1);
-  PRINTF("%u B\n", len);
-
-#if USE_HW_ADDRESS_FILTER
-  /* get destination address high byte to determine if to be ACKed (later) */
-  cc2500_read_burst(CC2500_RXFIFO, &dest, 1);
-  PRINTF("%u\n", dest);
-#endif /* USE_HW_ADDRESS_FILTER */
 
+  if(rx_len == 0) {
+    if(avail == 0) {
+      /* nothing in FIFO; any unread interrupts were for our own transmissions */
+      rx_eop_read = rx_eop;
+      return 0;
+    }
+    if(avail == 1 && CC2500_STATUS() == CC2500_STATE_RX) {
+      /* a lone length byte of a frame still being received; reading the last
+        byte in the RxFIFO during reception can corrupt it (see the CC2500
+        errata), so wait for the end-of-packet interrupt of that frame */
+      return 0;
+    }
 
-  /* Check size; too small (ie no real "data") -> drop it */
-  if(len == 0) {
-    FLUSH_FIFOS();
-    PRINTF("No data;F\n");
-    return 0;
+    /* first byte in FIFO is length of the packet with no appended footer */
+    cc2500_read_burst(CC2500_RXFIFO, &rx_len, 1);
+    avail--;
+    PRINTF("%u B\n", rx_len);
+
+    /* Check size; too small (ie no real "data") or corrupt -> drop it, and
+      with it the rest of the FIFO as we no longer know where frames start */
+    if(rx_len == 0) {
+      flush_rx();
+      RIMESTATS_ADD(tooshort);
+      PRINTF("No data;F\n");
+      return 0;
+    }
+    if(rx_len > CC2500_MAX_PACKET_LEN) {
+      flush_rx();
+      RIMESTATS_ADD(toolong);
+      PRINTF("Bad len;F\n");
+      return 0;
+    }
   }
 
-  /* corrupt size -> drop it */
-  if(len > CC2500_MAX_PACKET_LEN) {
-    FLUSH_FIFOS();
-    PRINTF("Bad len;F\n");
+  /* the rest of the frame is still being received; its end-of-packet interrupt
+    will poll the driver process again */
+  if(avail < rx_len + FOOTER_LEN) {
     return 0;
   }
+  len = rx_len;
+  rx_len = 0;
 
-  /* Check size; too big for buffer -> drop it */
+  /* Check size; too big for buffer -> read it out and drop it */
   if(len > bufsize) {
-/*  if(len - FOOTER_LEN > bufsize) {*/
-    FLUSH_FIFOS();
+    for(; len > 0; len--) {
+      cc2500_read_burst(CC2500_RXFIFO, footer, 1);
+    }
+    CC2500_READ_FIFO_BUF(footer, FOOTER_LEN);
+    rx_timestamp();
+    RIMESTATS_ADD(toolong);
     PRINTF("Too big(%u);F\n", bufsize);
-    return 0;
+    return -1;
   }
 
-  /* read the packet data from RxFIFO, put in packetbuf */
+  /* read the packet data from RxFIFO, then the automatically appended data
+    (RSSI, LQI, CRC ok) */
   CC2500_READ_FIFO_BUF(buf, len);
+  CC2500_READ_FIFO_BUF(footer, FOOTER_LEN);
+  timestamp = rx_timestamp();
 
-  /* read automatically appended data (RSSI, LQI, CRC ok) */
-  if(FOOTER_LEN > 0) {
-    CC2500_READ_FIFO_BUF(footer, FOOTER_LEN);
-  }
-
-  if(footer[1] & FOOTER1_CRC_OK) {
-    /* set attributes: RSSI and LQI so they can be read out from packetbuf */
-    packetbuf_set_attr(PACKETBUF_ATTR_RSSI, footer[0]);
-    packetbuf_set_attr(PACKETBUF_ATTR_LINK_QUALITY, footer[1] & FOOTER1_LQI);
-  } else {
+  if(!(footer[1] & FOOTER1_CRC_OK)) {
     /* CRC fail -> drop packet */
-    FLUSH_FIFOS();
-    PRINTF("CRC fail;F\n");
-    return 0;
-  }
-
-  /* check for FIFO overflow or if anything else is left in FIFO */
-  if(CC2500_STATUS() == CC2500_STATE_RXFIFO_OVERFLOW) {
-    FLUSH_FIFOS();
-  } else {
-    uint8_t l = cc2500_read_single(CC2500_RXBYTES);
-    if(l > 0) {
-       //XXX another packet in buffer, handle it 
-      pending_rxfifo++;
-      process_poll(&cc2500_process);
-    }
-  }
-
-
-#if USE_HW_ADDRESS_FILTER
-  /* check if unicast, if so we ACK it (not broadcast or to us are already
-    filtered out by radio HW) */
-  /* XXX move earlier to save sender energy? if not interferes with reading rxfifo */
-  if(dest != 0) {
-    uint8_t ab[ACK_LEN];  // ACK-buffer
-    uint8_t len;
-    
-    len = NETSTACK_RADIO.read(ab, ACK_LEN);
-    if(len == ACK_LEN && 
-          ab[0] = packetbuf_addr(PACKETBUF_ADDR_RECEIVER)->u8[0] &&
-          ab[1] = packetbuf_addr(PACKETBUF_ADDR_RECEIVER)->u8[1] &&
-          ab[2] = tx_serial) {
-      /* ACK received */
-      PRINTF("Got ACK!\n");
+    RIMESTATS_ADD(badcrc);
+    PRINTF("CRC fail\n");
+    return -1;
   }
-#endif /* USE_HW_ADDRESS_FILTER */
-
-
 
+  /* set attributes: RSSI and LQI so they can be read out from packetbuf */
+  packetbuf_set_attr(PACKETBUF_ATTR_RSSI, footer[0]);
+  packetbuf_set_attr(PACKETBUF_ATTR_LINK_QUALITY, footer[1] & FOOTER1_LQI);
+  packetbuf_set_attr(PACKETBUF_ATTR_TIMESTAMP, timestamp);
+  RIMESTATS_ADD(llrx);
+  return len;
+}
+/*---------------------------------------------------------------------------*/
+static int
+cc2500_read(void *buf, unsigned short bufsize)
+{
+  int len;
 
-#if 0
-  if(CC2500_FIFOP_IS_1) {
-    if(!CC2500_FIFO_IS_1) {
-      /* Clean up in case of FIFO overflow!  This happens for every
-       * full length frame and is signaled by FIFOP = 1 and FIFO =
-       * 0. */
-      flushrx();
-    }
-  }
-#endif
+  PRINTF("CC2500:r\n");
 
+  /* skip any bad frames and return the first good one, if any */
+  do {
+    len = read_frame(buf, bufsize);
+  } while(len < 0);
   return len;
 }
 /*---------------------------------------------------------------------------*/
@@ -684,7 +945,7 @@ cc2500_receiving_packet(void)
 static int
 cc2500_pending_packet(void)
 {
-  return pending_rxfifo;
+  return rx_eop != rx_eop_read || rx_len != 0;
 }
 /*--------------------------------------------------------------------------*/
 uint8_t
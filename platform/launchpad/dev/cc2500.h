@@ -118,6 +118,9 @@ int     cc2500_off(void);
 int     cc2500_send(const void *payload, unsigned short payload_len);
 
 void    cc2500_set_channel(uint8_t c);
+void    cc2500_set_sniff(uint8_t enable);
+void    cc2500_set_tx_repeat(uint8_t enable);
+void    cc2500_set_address(uint8_t addr);
 uint8_t cc2500_strobe(uint8_t strobe);
 uint8_t cc2500_read_single(uint8_t adr);
 uint8_t cc2500_read_burst(uint8_t adr, uint8_t *dest, uint8_t len);
@@ -50,4 +50,12 @@ void uart0_writeb(unsigned char c);
 void uart0_init(unsigned long ubr);
 uint8_t uart0_active(void);
 
+/* Non-zero while buffered bytes remain to be moved to the UART by the
+   TX interrupt. */
+uint8_t uart0_tx_pending(void);
+
+/* Set a function to be called, from the TX interrupt, when the buffer
+   has been emptied. The last byte is then still being shifted out. */
+void uart0_set_tx_drained(void (*callback)(void));
+
 #endif /* __UART0_H__ */
@@ -0,0 +1,685 @@
+/*
+ * Copyright (c) 2013
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the Institute nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE INSTITUTE AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE INSTITUTE OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ *
+ */
+
+/**
+ * \file
+ *         A radio duty cycling layer for the CC2500 that uses the radio's
+ *         Wake-on-Radio mode, so that the MCU sleeps through channel checks.
+ */
+
+#include <string.h>
+#include "contiki.h"
+#include "net/rime.h"
+#include "net/netstack.h"
+#include "dev/wor-rdc.h"
+#include "dev/cc2500.h"
+#include "dev/cc2500-const.h"
+#include "dev/watchdog.h"
+#include "sys/ctimer.h"
+
+/*---------------------------------------------------------------------------*/
+#define DEBUG 0
+#if DEBUG
+#include <stdio.h>
+#define PRINTF(...) printf(__VA_ARGS__)
+#else
+#define PRINTF(...)
+#endif
+/*---------------------------------------------------------------------------*/
+#if 0
+
+Short explanation of WOR-RDC:
+  SimpleRDC wakes up the MCU from an etimer to turn on the radio and check the
+  channel. Here the CC2500 does the channel checks by itself: in Wake-on-Radio
+  (WOR) it sleeps, and its RC oscillator wakes it up every EVENT0 period to
+  listen for a while. If it finds nothing it goes back to sleep on its own, and
+  the MCU is only woken up by the end-of-packet interrupt when a frame has been
+  received. After reading out the frame, the radio driver puts the radio back
+  in WOR.
+
+  To send, we transmit the frame over and over for a full check interval plus
+  a little more, so that the receiver hears at least one whole copy when it
+  wakes up. A small header with a sequence number lets the receiver drop the
+  copies it has already seen.
+
+    | = tx
+    - = rx
+    _ = sleep (radio on its own, MCU not involved)
+
+    receiver  ______-______________-______________-_____________
+                    ^ EVENT0 period, rx for at most RX_TIME
+
+    sender    ____________||||||||||||||||||______________________
+                          |---- TX_PERIOD ---|
+
+  The copies go out back to back: the radio is calibrated once before the
+  train and then stays in Tx (see cc2500_set_tx_repeat()), so between two
+  copies there is only preamble and sync word, and the carrier never drops.
+  With WORRDC_CONF_RSSI_STOP, on by default, the radio therefore stops
+  listening as soon as it finds no carrier, which typically leaves it in Rx for
+  less than 0.5 ms per wakeup, a radio duty cycle of about 0.4 % at 8 Hz plus
+  the crystal oscillator start-up (EVENT1). A wakeup that lands in a train
+  hears the carrier and keeps listening for the next sync word, up to
+  WORRDC_CONF_RX_TIME (MCSM2.RX_TIME), about 2 ms at 8 Hz by default. That
+  must be longer than one copy of the longest frame, and it only costs anything
+  while a train is on the air.
+
+  With a radio driver that has transmit_async(), the train is sent by
+  worrdc_process: each copy is written to the TxFIFO while the one before it
+  is still on the air, and the MCU sleeps until the radio reports it sent. The
+  MAC layer callback then comes from that process. The frame is kept in a
+  queuebuf meanwhile, so without a free one (QUEUEBUF_CONF_NUM), and for
+  unicast trains that listen for ACKs, the train is sent in a busy loop.
+
+  With WORRDC_CONF_ACK_UNICAST, a unicast is ACKed as soon as it has been read
+  out of the radio, and the sender listens for the ACK after each copy so it can
+  stop early. Unicast trains then have gaps of about 1 ms (the radio goes to
+  IDLE, the TxFIFO is flushed and rewritten, and every 4th STX calibrates),
+  which must be shorter than the time the receiver listens, so ACKs come with a
+  longer RX_TIME and no RSSI stop, ie a higher duty cycle for everyone in
+  exchange for shorter unicast trains. The radio filters frames on the first
+  receiver address byte (see the CC2500 driver), and the ACK starts with the
+  address of the node it is for, so it never wakes up the MCU of any other
+  node.
+
+  Bursts: when the MAC layer (eg csma) hands over several queued frames for the
+  same neighbor at once, all but the last are sent with the pending flag set in
+  the header. The receiver then stays in Rx instead of going back to WOR, until
+  a frame without the flag arrives or nothing has come for
+  INTER_PACKET_DEADLINE. With WORRDC_CONF_ACK_UNICAST, once the receiver has
+  ACKed a frame with the flag, the sender knows it is listening and sends the
+  rest as BURST_COPIES copies each, so a burst shares a single rendezvous.
+  Without ACKs the sender cannot tell whether the first frame was heard, so
+  every frame still gets a full train.
+
+    receiver  ______-----------------------------------_____________
+    sender    __||||||||||||||||||||||||| || || ||______________________
+                 first frame, full train  ^  ^  ^ the rest of the burst
+
+#endif /* if 0; commented out code */
+/*---------------------------------------------------------------------------*/
+/* at what rate the radio wakes up and checks for traffic, in Hz */
+#ifdef WORRDC_CONF_CHECKRATE
+#define WORRDC_CHECKRATE              WORRDC_CONF_CHECKRATE
+#else
+#define WORRDC_CHECKRATE              NETSTACK_RDC_CHANNEL_CHECK_RATE
+#endif
+
+/* ACK unicasts, so that the sender can end the packet train early */
+#ifdef WORRDC_CONF_ACK_UNICAST
+#define WORRDC_ACK_UNICAST            WORRDC_CONF_ACK_UNICAST
+#else
+#define WORRDC_ACK_UNICAST            0
+#endif
+
+/* longest time to listen at each wakeup, as MCSM2.RX_TIME: 0 is 12.5 % of the
+  check interval, and every step up halves that down to 6 for 0.195 %; with the
+  RSSI stop only wakeups that hear a carrier listen this long */
+#ifdef WORRDC_CONF_RX_TIME
+#define WORRDC_RX_TIME                WORRDC_CONF_RX_TIME
+#elif WORRDC_ACK_UNICAST
+#define WORRDC_RX_TIME                2
+#else
+#define WORRDC_RX_TIME                3
+#endif
+
+/* stop listening early if no carrier is sensed; not with ACKs, as unicast
+  trains then have gaps, see above */
+#ifdef WORRDC_CONF_RSSI_STOP
+#define WORRDC_RSSI_STOP              WORRDC_CONF_RSSI_STOP
+#elif WORRDC_ACK_UNICAST
+#define WORRDC_RSSI_STOP              0
+#else
+#define WORRDC_RSSI_STOP              1
+#endif
+
+/* EVENT0 counts periods of the RC oscillator, at 26 MHz / 750 */
+#define CC2500_XOSC_FREQ              26000000UL
+#define WOR_EVENT0                    (CC2500_XOSC_FREQ / 750 / WORRDC_CHECKRATE)
+
+/* for how long to transmit, a little more than a check interval */
+#define TX_PERIOD                     ((CLOCK_SECOND / WORRDC_CHECKRATE) + 2)
+
+/* how long to listen for an ACK after each copy of a unicast */
+#define ACK_WAIT_TIME                 ((2ul * RTIMER_SECOND) / 1000)
+
+/* copies of each frame after the first in a burst, when the receiver is awake */
+#define BURST_COPIES                  2
+
+/* how long a receiver waits for the next frame of a burst */
+#define INTER_PACKET_DEADLINE         (CLOCK_SECOND / 32)
+
+/* how much longer than TX_PERIOD a train sent by worrdc_process may take */
+#define TX_TIMEOUT                    (CLOCK_SECOND / 32)
+/*---------------------------------------------------------------------------*/
+/* WOR-RDC header, for dropping the copies of a frame already received; the top
+  bit of the sequence number byte flags that more frames follow in a burst */
+struct hdr {
+  uint8_t seqno;
+};
+#define HDR_SEQNO     0x7f
+#define HDR_PENDING   0x80
+
+/* keep a record of the last few received packets, 3 B per sender */
+struct seqno {
+  rimeaddr_t sender;
+  uint8_t seqno;
+};
+
+#ifdef NETSTACK_CONF_MAC_SEQNO_HISTORY
+#define MAX_SEQNOS NETSTACK_CONF_MAC_SEQNO_HISTORY
+#else /* NETSTACK_CONF_MAC_SEQNO_HISTORY */
+#define MAX_SEQNOS 2
+#endif /* NETSTACK_CONF_MAC_SEQNO_HISTORY */
+static struct seqno received_seqnos[MAX_SEQNOS];
+
+/* ACK frame, starting with the address of the node that sent the unicast */
+struct ack {
+  rimeaddr_t receiver;
+  uint8_t seqno;
+};
+#define ACK_LEN       sizeof(struct ack)
+
+static uint8_t worrdc_is_on = 0;
+
+/* sending a burst, and the receiver has ACKed a frame of it with the pending
+  flag, so it is listening */
+static uint8_t is_receiver_awake = 0;
+/* receiving a burst; the radio is kept in Rx until it ends */
+static uint8_t we_are_receiving_burst = 0;
+static struct ctimer burst_timer;
+
+/* the frame being sent */
+static uint8_t frame_seqno;
+#if WORRDC_ACK_UNICAST
+static uint8_t is_unicast, is_pending;
+#endif /* WORRDC_ACK_UNICAST */
+
+/* The rest of the burst being sent, where to report each frame, and the frame
+  whose train worrdc_process is sending. tx_status and tx_is_done are set by
+  tx_done() when a copy has been sent. */
+static struct rdc_buf_list *tx_list;
+static mac_callback_t tx_sent;
+static void *tx_ptr;
+static struct queuebuf *tx_qb;
+static uint8_t tx_hdrlen;
+static volatile int tx_status;
+static volatile uint8_t tx_is_done;
+
+PROCESS(worrdc_process, "WOR-RDC");
+/*---------------------------------------------------------------------------*/
+/* program the WOR timing into the radio */
+static void
+wor_setup(void)
+{
+  uint8_t wor[3];
+
+  wor[0] = (uint8_t)(WOR_EVENT0 >> 8);          /* WOREVT1 */
+  wor[1] = (uint8_t)(WOR_EVENT0 & 0xff);        /* WOREVT0 */
+  wor[2] = WORCTRL_EVENT1(4) | WORCTRL_RC_CAL;  /* WORCTRL, RC osc on, WOR_RES 0 */
+  cc2500_write_burst(CC2500_WOREVT1, wor, sizeof(wor));
+
+  cc2500_write_single(CC2500_MCSM2, RX_TIME_QUAL | WORRDC_RX_TIME |
+                      (WORRDC_RSSI_STOP ? RX_TIME_RSSI : 0));
+
+  /* the radio is never calibrated by hand while in WOR, so let it do that */
+  cc2500_write_single(CC2500_MCSM0, FS_AUTOCAL_4TH | PO_TIMEOUT_2);
+}
+/*---------------------------------------------------------------------------*/
+#if WORRDC_ACK_UNICAST
+/* listen for a while for the ACK of the unicast with this sequence number */
+static int
+wait_for_ack(uint8_t seqno)
+{
+  struct ack ack;
+  rtimer_clock_t t0;
+
+  t0 = RTIMER_NOW();
+  while(RTIMER_CLOCK_LT(RTIMER_NOW(), t0 + ACK_WAIT_TIME)) {
+    /* frames longer than an ACK are dropped by the driver */
+    if(NETSTACK_RADIO.read(&ack, ACK_LEN) == ACK_LEN &&
+       ack.seqno == seqno &&
+       rimeaddr_cmp(&ack.receiver, &rimeaddr_node_addr)) {
+      return 1;
+    }
+  }
+  return 0;
+}
+/*---------------------------------------------------------------------------*/
+static void
+send_ack(uint8_t seqno)
+{
+  struct ack ack;
+
+  rimeaddr_copy(&ack.receiver, packetbuf_addr(PACKETBUF_ADDR_SENDER));
+  ack.seqno = seqno;
+  NETSTACK_RADIO.send(&ack, ACK_LEN);
+}
+#endif /* WORRDC_ACK_UNICAST */
+/*---------------------------------------------------------------------------*/
+/* See if the RDC layer can send and the channel is clear, add the WOR-RDC
+  header to the frame in the packetbuf and turn the radio on for it. Returns
+  MAC_TX_OK if the frame can be sent, otherwise the radio is left off. */
+static int
+begin_frame(void)
+{
+  static uint8_t tx_seqno = 1;
+  struct hdr *chdr;
+
+  if(!worrdc_is_on) {
+    PRINTF("worrdc: radio is turned off\n");
+    return MAC_TX_ERR_FATAL;
+  }
+  if(packetbuf_totlen() == 0) {
+    PRINTF("worrdc: send data len 0\n");
+    return MAC_TX_ERR_FATAL;
+  }
+
+  packetbuf_set_addr(PACKETBUF_ADDR_SENDER, &rimeaddr_node_addr);
+  if(packetbuf_hdralloc(sizeof(struct hdr)) == 0) {
+    PRINTF("worrdc: send failed, too large header\n");
+    return MAC_TX_ERR_FATAL;
+  }
+  chdr = packetbuf_hdrptr();
+  frame_seqno = tx_seqno++ & HDR_SEQNO;
+  chdr->seqno = frame_seqno;
+  if(packetbuf_attr(PACKETBUF_ATTR_PENDING)) {
+    chdr->seqno |= HDR_PENDING;
+  }
+#if WORRDC_ACK_UNICAST
+  is_unicast = !rimeaddr_cmp(packetbuf_addr(PACKETBUF_ADDR_RECEIVER), &rimeaddr_null);
+  is_pending = packetbuf_attr(PACKETBUF_ATTR_PENDING) != 0;
+#endif /* WORRDC_ACK_UNICAST */
+  if(NETSTACK_FRAMER.create() < 0) {
+    PRINTF("worrdc: send failed, too large header\n");
+    packetbuf_hdr_remove(sizeof(struct hdr));
+    return MAC_TX_ERR_FATAL;
+  }
+
+  /* wake the radio up to check the channel and send */
+  NETSTACK_RADIO.on();
+  if(NETSTACK_RADIO.receiving_packet() || NETSTACK_RADIO.pending_packet() ||
+     NETSTACK_RADIO.channel_clear() == 0) {
+    NETSTACK_RADIO.off();
+    return MAC_TX_COLLISION;
+  }
+  return MAC_TX_OK;
+}
+/*---------------------------------------------------------------------------*/
+/* the copies go out back to back, unless we listen for an ACK between them */
+static uint8_t
+is_repeat(void)
+{
+#if WORRDC_ACK_UNICAST
+  return !is_unicast;
+#else /* WORRDC_ACK_UNICAST */
+  return 1;
+#endif /* WORRDC_ACK_UNICAST */
+}
+/*---------------------------------------------------------------------------*/
+/* the MAC status of a train, from the status of the last copy */
+static int
+end_frame(int ret)
+{
+  NETSTACK_RADIO.off();
+
+  if(ret == RADIO_TX_COLLISION) {
+    return MAC_TX_COLLISION;
+  } else if(ret != RADIO_TX_OK) {
+    return MAC_TX_ERR;
+  }
+#if WORRDC_ACK_UNICAST
+  if(is_unicast) {
+    return MAC_TX_NOACK;
+  }
+#endif /* WORRDC_ACK_UNICAST */
+  return MAC_TX_OK;
+}
+/*---------------------------------------------------------------------------*/
+/* send the train of the frame in the packetbuf, spinning until it is done */
+static int
+send_copies(void)
+{
+  clock_time_t start;
+  uint8_t copies;
+  int ret;
+
+  if(is_repeat()) {
+    cc2500_set_tx_repeat(1);
+  }
+
+  /* the TXFIFO is emptied by each transmission, so copy the frame for each */
+  ret = RADIO_TX_OK;
+  copies = 0;
+  start = clock_time();
+  while(ret == RADIO_TX_OK && (clock_time_t)(clock_time() - start) < TX_PERIOD) {
+    watchdog_periodic();
+    NETSTACK_RADIO.prepare(packetbuf_hdrptr(), packetbuf_totlen());
+    ret = NETSTACK_RADIO.transmit(packetbuf_totlen());
+#if WORRDC_ACK_UNICAST
+    if(ret == RADIO_TX_OK && is_unicast && wait_for_ack(frame_seqno)) {
+      NETSTACK_RADIO.off();
+      /* it heard the pending flag, so it stays in Rx for the next frame */
+      is_receiver_awake = is_pending;
+      return MAC_TX_OK;
+    }
+#endif /* WORRDC_ACK_UNICAST */
+    /* in a burst, the receiver is already listening */
+    if(is_receiver_awake && ++copies == BURST_COPIES) {
+      break;
+    }
+  }
+  if(is_repeat()) {
+    cc2500_set_tx_repeat(0);
+  }
+  return end_frame(ret);
+}
+/*---------------------------------------------------------------------------*/
+/* Send the frame in the packetbuf. Returns MAC_TX_DEFERRED if its train has
+  been handed to worrdc_process, which calls tx_sent when it is done. */
+static int
+send_frame(void)
+{
+  int ret;
+
+  ret = begin_frame();
+  if(ret != MAC_TX_OK) {
+    return ret;
+  }
+  if(is_repeat() && NETSTACK_RADIO.transmit_async != NULL) {
+    /* the packetbuf is not ours while the process waits */
+    tx_qb = queuebuf_new_from_packetbuf();
+    if(tx_qb != NULL) {
+      tx_hdrlen = packetbuf_hdrlen();
+      process_poll(&worrdc_process);
+      return MAC_TX_DEFERRED;
+    }
+  }
+  return send_copies();
+}
+/*---------------------------------------------------------------------------*/
+/* Send the rest of the burst in tx_list, until a frame fails or is deferred */
+static void
+send_list(void)
+{
+  struct rdc_buf_list *curr;
+  int ret;
+
+  while(tx_list != NULL) {
+    curr = tx_list;
+    tx_list = list_item_next(curr);
+    queuebuf_to_packetbuf(curr->buf);
+    if(tx_list != NULL) {
+      packetbuf_set_attr(PACKETBUF_ATTR_PENDING, 1);
+    }
+    ret = send_frame();
+    if(ret == MAC_TX_DEFERRED) {
+      return;
+    }
+    /* this may free curr */
+    mac_call_sent_callback(tx_sent, tx_ptr, ret, 1);
+    if(ret != MAC_TX_OK) {
+      break;
+    }
+  }
+  tx_list = NULL;
+  is_receiver_awake = 0;
+}
+/*---------------------------------------------------------------------------*/
+/* the end of a copy sent with transmit_async(), from interrupt context */
+static void
+tx_done(void *ptr, int status)
+{
+  tx_status = status;
+  tx_is_done = 1;
+  process_poll(&worrdc_process);
+}
+/*---------------------------------------------------------------------------*/
+/* Send the train of the frame in tx_qb. Each copy is written to the TxFIFO
+  while the one before it is still on the air, and the MCU sleeps until the
+  radio reports that copy sent. */
+PROCESS_THREAD(worrdc_process, ev, data)
+{
+  static struct etimer et;
+  static clock_time_t start;
+  static int ret;
+
+  PROCESS_BEGIN();
+
+  while(1) {
+    PROCESS_WAIT_EVENT_UNTIL(tx_qb != NULL);
+
+    cc2500_set_tx_repeat(1);
+    /* in case the radio never reports a copy sent */
+    etimer_set(&et, TX_PERIOD + TX_TIMEOUT);
+    start = clock_time();
+    NETSTACK_RADIO.prepare(queuebuf_dataptr(tx_qb), queuebuf_datalen(tx_qb));
+    tx_is_done = 0;
+    ret = NETSTACK_RADIO.transmit_async(queuebuf_datalen(tx_qb), tx_done, NULL);
+    while(ret == RADIO_TX_OK && (clock_time_t)(clock_time() - start) < TX_PERIOD) {
+      watchdog_periodic();
+      NETSTACK_RADIO.prepare(queuebuf_dataptr(tx_qb), queuebuf_datalen(tx_qb));
+      PROCESS_WAIT_UNTIL(tx_is_done || etimer_expired(&et));
+      ret = tx_is_done ? tx_status : RADIO_TX_ERR;
+      if(ret == RADIO_TX_OK) {
+        tx_is_done = 0;
+        ret = NETSTACK_RADIO.transmit_async(queuebuf_datalen(tx_qb), tx_done, NULL);
+      }
+    }
+    if(ret == RADIO_TX_OK) {
+      PROCESS_WAIT_UNTIL(tx_is_done || etimer_expired(&et));
+      ret = tx_is_done ? tx_status : RADIO_TX_ERR;
+    }
+    etimer_stop(&et);
+    cc2500_set_tx_repeat(0);
+    ret = end_frame(ret);
+
+    /* leave the packetbuf as send_copies() does, the data after the headers */
+    queuebuf_to_packetbuf(tx_qb);
+    packetbuf_hdrreduce(tx_hdrlen);
+    queuebuf_free(tx_qb);
+    tx_qb = NULL;
+    mac_call_sent_callback(tx_sent, tx_ptr, ret, 1);
+    if(ret == MAC_TX_OK) {
+      send_list();
+    } else {
+      tx_list = NULL;
+      is_receiver_awake = 0;
+    }
+  }
+
+  PROCESS_END();
+}
+/*---------------------------------------------------------------------------*/
+static void
+qsend_packet(mac_callback_t sent, void *ptr)
+{
+  int ret;
+
+  if(tx_qb != NULL || tx_list != NULL) {
+    /* still sending a train */
+    ret = MAC_TX_COLLISION;
+  } else {
+    tx_sent = sent;
+    tx_ptr = ptr;
+    ret = send_frame();
+    if(ret == MAC_TX_DEFERRED) {
+      return;
+    }
+  }
+  mac_call_sent_callback(sent, ptr, ret, 1);
+}
+/*---------------------------------------------------------------------------*/
+/* Send the frames in the list as a burst, see the explanation at the top. The
+  list is the queue of one neighbor (eg from csma), and each frame is reported
+  to the callback as it is sent, which may free it. */
+static void
+qsend_list(mac_callback_t sent, void *ptr, struct rdc_buf_list *buf_list)
+{
+  if(buf_list == NULL) {
+    return;
+  }
+  /* do not send while receiving a burst, or while still sending */
+  if(we_are_receiving_burst || tx_qb != NULL || tx_list != NULL) {
+    queuebuf_to_packetbuf(buf_list->buf);
+    mac_call_sent_callback(sent, ptr, MAC_TX_COLLISION, 1);
+    return;
+  }
+
+  is_receiver_awake = 0;
+  tx_sent = sent;
+  tx_ptr = ptr;
+  tx_list = buf_list;
+  send_list();
+}
+/*---------------------------------------------------------------------------*/
+/* the burst we were receiving has ended, or timed out; back to WOR */
+static void
+recv_burst_off(void *ptr)
+{
+  if(NETSTACK_RADIO.off()) {
+    we_are_receiving_burst = 0;
+  } else {
+    /* still busy receiving; the next input will turn it off, or this */
+    ctimer_set(&burst_timer, INTER_PACKET_DEADLINE, recv_burst_off, NULL);
+  }
+}
+/*---------------------------------------------------------------------------*/
+static void
+input_packet(void)
+{
+  struct hdr *chdr;
+  uint8_t i, seqno;
+
+  if(packetbuf_totlen() == 0 || NETSTACK_FRAMER.parse() < 0) {
+    PRINTF("worrdc: failed to parse (%u)\n", packetbuf_totlen());
+    return;
+  }
+  chdr = packetbuf_dataptr();
+  if(!packetbuf_hdrreduce(sizeof(struct hdr))) {
+    return;
+  }
+
+  if(!rimeaddr_cmp(packetbuf_addr(PACKETBUF_ADDR_RECEIVER), &rimeaddr_node_addr) &&
+     !rimeaddr_cmp(packetbuf_addr(PACKETBUF_ADDR_RECEIVER), &rimeaddr_null)) {
+    PRINTF("worrdc: data not for us\n");
+    return;
+  }
+
+  seqno = chdr->seqno & HDR_SEQNO;
+
+#if WORRDC_ACK_UNICAST
+  /* ACK before anything else so that the sender can stop; duplicates too, as
+    the sender may have missed the first ACK */
+  if(rimeaddr_cmp(packetbuf_addr(PACKETBUF_ADDR_RECEIVER), &rimeaddr_node_addr)) {
+    send_ack(seqno);
+  }
+#endif /* WORRDC_ACK_UNICAST */
+
+  /* Stay awake while a burst to us goes on; copies of a frame count too, as
+    the train of the first frame can outlast the deadline. */
+  if(rimeaddr_cmp(packetbuf_addr(PACKETBUF_ADDR_RECEIVER), &rimeaddr_node_addr)) {
+    if(chdr->seqno & HDR_PENDING) {
+      we_are_receiving_burst = 1;
+      NETSTACK_RADIO.on();
+      ctimer_set(&burst_timer, INTER_PACKET_DEADLINE, recv_burst_off, NULL);
+    } else if(we_are_receiving_burst) {
+      ctimer_stop(&burst_timer);
+      recv_burst_off(NULL);
+    }
+  }
+
+  /* drop the copies of a frame that we have already received */
+  for(i = 0; i < MAX_SEQNOS; ++i) {
+    if(seqno == received_seqnos[i].seqno &&
+       rimeaddr_cmp(&received_seqnos[i].sender,
+                    packetbuf_addr(PACKETBUF_ADDR_SENDER))) {
+      PRINTF("worrdc: drop duplicate %u\n", chdr->seqno);
+      return;
+    }
+  }
+  for(i = MAX_SEQNOS - 1; i > 0; --i) {
+    memcpy(&received_seqnos[i], &received_seqnos[i - 1], sizeof(struct seqno));
+  }
+  received_seqnos[0].seqno = seqno;
+  rimeaddr_copy(&received_seqnos[0].sender, packetbuf_addr(PACKETBUF_ADDR_SENDER));
+
+  PRINTF("worrdc: data (%u)\n", packetbuf_datalen());
+  NETSTACK_MAC.input();
+}
+/*---------------------------------------------------------------------------*/
+static int
+turn_on(void)
+{
+  worrdc_is_on = 1;
+  NETSTACK_RADIO.off();
+  cc2500_set_sniff(1);
+  return 1;
+}
+/*---------------------------------------------------------------------------*/
+static int
+turn_off(int keep_radio_on)
+{
+  worrdc_is_on = 0;
+  we_are_receiving_burst = 0;
+  ctimer_stop(&burst_timer);
+  cc2500_set_sniff(0);
+  if(keep_radio_on) {
+    return NETSTACK_RADIO.on();
+  }
+  return NETSTACK_RADIO.off();
+}
+/*---------------------------------------------------------------------------*/
+static void
+init(void)
+{
+  PRINTF("WOR-RDC starting\n");
+  process_start(&worrdc_process, NULL);
+  wor_setup();
+  turn_on();
+}
+/*---------------------------------------------------------------------------*/
+static unsigned short
+channel_check_interval(void)
+{
+  return CLOCK_SECOND / WORRDC_CHECKRATE;
+}
+/*---------------------------------------------------------------------------*/
+const struct rdc_driver worrdc_driver = {
+  "WOR-RDC",
+  init,
+  qsend_packet,
+  qsend_list,
+  input_packet,
+  turn_on,
+  turn_off,
+  channel_check_interval,
+};
+/*---------------------------------------------------------------------------*/
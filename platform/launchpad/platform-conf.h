@@ -152,9 +152,9 @@ Here is a short summary of the Launchpad mcu's
 //#define BUTTON_CONF_PORT        P1
 //#define BUTTON_CONF_PIN         (1<<3)
 
-/* use irq/dma with UART to save system resources, otherwise synchrous (blocking) */
-// XXX not working yet, is only blocking so leave as 0 now.
-#define UART0_CONF_TX_WITH_INTERRUPT  0
+/* buffer UART output and send it from the TX interrupt, otherwise synchronous
+   (blocking) */
+#define UART0_CONF_TX_WITH_INTERRUPT  1
 
 /* this is where in memory the node id is stored (must first be written by burn),
   these memory locations are non-volatile and will not be erased by a 'full erase'
@@ -180,6 +180,7 @@ Here is a short summary of the Launchpad mcu's
 /* Clock resolutions */
 #define CLOCK_CONF_SECOND               (128UL)
 #define RTIMER_CONF_SECOND              32768
+#define CLOCK_CONF_TICKLESS             1     /* no clock interrupts when idle */
 
 /* Types for clocks and uip_stats */
 typedef unsigned short uip_stats_t;
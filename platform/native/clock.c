@@ -42,6 +42,31 @@
 #include <time.h>
 #include <sys/time.h>
 
+#if CLOCK_CONF_VIRTUAL
+static clock_time_t now;
+/*---------------------------------------------------------------------------*/
+clock_time_t
+clock_time(void)
+{
+  return now;
+}
+/*---------------------------------------------------------------------------*/
+unsigned long
+clock_seconds(void)
+{
+  return now / CLOCK_SECOND;
+}
+/*---------------------------------------------------------------------------*/
+void
+clock_jump(clock_time_t t)
+{
+  /* time never goes backwards */
+  if((long)(t - now) > 0) {
+    now = t;
+  }
+}
+/*---------------------------------------------------------------------------*/
+#else /* CLOCK_CONF_VIRTUAL */
 /*---------------------------------------------------------------------------*/
 clock_time_t
 clock_time(void)
@@ -62,6 +87,7 @@ clock_seconds(void)
  
   return tv.tv_sec;
 }
+#endif /* CLOCK_CONF_VIRTUAL */
 /*---------------------------------------------------------------------------*/
 void
 clock_delay(unsigned int d)
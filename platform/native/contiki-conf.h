@@ -181,4 +181,29 @@ int strcasecmp(const char*, const char*);
 #include PROJECT_CONF_H
 #endif /* PROJECT_CONF_H */
 
+/* Run on virtual time: the clock starts at zero and stands still while
+   there is work to do. When all processes are idle and no descriptor
+   is ready, it jumps to the next etimer or rtimer deadline, so that
+   long simulated runs take only as long as the processing they need.
+   Code that busy-waits on clock_time() or RTIMER_NOW() never returns. */
+#ifndef CLOCK_CONF_VIRTUAL
+#define CLOCK_CONF_VIRTUAL 0
+#endif /* CLOCK_CONF_VIRTUAL */
+
+#if CLOCK_CONF_VIRTUAL
+void clock_jump(clock_time_t t);
+int rtimer_arch_next(clock_time_t *t);
+void rtimer_arch_run_due(void);
+#endif /* CLOCK_CONF_VIRTUAL */
+
+/* Native builds have RAM to spare for the fastest CRC16 tables. */
+#ifndef CRC16_CONF_IMPL
+#define CRC16_CONF_IMPL CRC16_SLICE8
+#endif /* CRC16_CONF_IMPL */
+
+/* Sum Internet checksums 32 bits at a time on 32- and 64-bit CPUs. */
+#ifndef UIP_CONF_WIDE_CHKSUM
+#define UIP_CONF_WIDE_CHKSUM 1
+#endif /* UIP_CONF_WIDE_CHKSUM */
+
 #endif /* __CONTIKI_CONF_H__ */
@@ -31,6 +31,7 @@
  *
  */
 
+#include <errno.h>
 #include <stdio.h>
 #include <string.h>
 #include <unistd.h>
@@ -63,14 +64,110 @@
 #define SELECT_MAX 8
 #endif
 
+/* Wait for file descriptors with Linux epoll instead of select(). The
+   descriptors are registered edge-triggered, and only the callbacks of
+   descriptors that have become ready are called, so the cost of the
+   main loop does not grow with the number of descriptors. */
+#ifndef SELECT_CONF_EPOLL
+#define SELECT_CONF_EPOLL 0
+#endif
+
+/* The longest time, in ms, the main loop waits for descriptors when no
+   etimer is due sooner. */
+#ifdef SELECT_CONF_MAX_WAIT
+#define SELECT_MAX_WAIT SELECT_CONF_MAX_WAIT
+#else
+#define SELECT_MAX_WAIT 1000
+#endif
+
+#if SELECT_MAX > FD_SETSIZE
+#error SELECT_CONF_MAX must not be larger than FD_SETSIZE
+#endif
+
+#if SELECT_CONF_EPOLL
+#include <poll.h>
+#include <stdlib.h>
+#include <sys/epoll.h>
+#endif /* SELECT_CONF_EPOLL */
+
 static const struct select_callback *select_callback[SELECT_MAX];
 static int select_max = 0;
 
+#if SELECT_CONF_EPOLL
+#define READY_READ  1
+#define READY_WRITE 2
+
+static int epoll_fd = -1;
+/* What each descriptor was last seen ready for. A bit is set when epoll
+   reports an edge and cleared when a poll() after the callback finds
+   the descriptor no longer ready. */
+static unsigned char ready[SELECT_MAX];
+/* The descriptors that have a bit set in ready[]. */
+static int ready_list[SELECT_MAX];
+static int ready_count;
+#endif /* SELECT_CONF_EPOLL */
+
 SENSORS(&pir_sensor, &vib_sensor, &button_sensor);
 
 static uint8_t serial_id[] = {0x01,0x02,0x03,0x04,0x05,0x06,0x07,0x08};
 static uint16_t node_id = 0x0102;
 /*---------------------------------------------------------------------------*/
+#if SELECT_CONF_EPOLL
+static void
+set_ready(int fd, unsigned char bits)
+{
+  if(ready[fd] == 0 && bits != 0) {
+    ready_list[ready_count++] = fd;
+  }
+  ready[fd] |= bits;
+}
+/*---------------------------------------------------------------------------*/
+static void
+clear_ready(int fd)
+{
+  int i;
+
+  ready[fd] = 0;
+  for(i = 0; i < ready_count; i++) {
+    if(ready_list[i] == fd) {
+      ready_list[i] = ready_list[--ready_count];
+      break;
+    }
+  }
+}
+/*---------------------------------------------------------------------------*/
+static void
+epoll_update(int fd, const struct select_callback *old,
+             const struct select_callback *callback)
+{
+  struct epoll_event ev;
+
+  if(epoll_fd < 0) {
+    epoll_fd = epoll_create(SELECT_MAX);
+    if(epoll_fd < 0) {
+      perror("epoll_create");
+      exit(1);
+    }
+  }
+
+  if(old == NULL && callback != NULL) {
+    memset(&ev, 0, sizeof(ev));
+    ev.events = EPOLLIN | EPOLLOUT | EPOLLET;
+    ev.data.fd = fd;
+    if(epoll_ctl(epoll_fd, EPOLL_CTL_ADD, fd, &ev) < 0) {
+      if(errno != EPERM) {
+        perror("epoll_ctl");
+      }
+      /* Regular files cannot be waited for; they are always ready. */
+      set_ready(fd, READY_READ | READY_WRITE);
+    }
+  } else if(old != NULL && callback == NULL) {
+    epoll_ctl(epoll_fd, EPOLL_CTL_DEL, fd, NULL);
+    clear_ready(fd);
+  }
+}
+#endif /* SELECT_CONF_EPOLL */
+/*---------------------------------------------------------------------------*/
 int
 select_set_callback(int fd, const struct select_callback *callback)
 {
@@ -82,6 +179,9 @@ select_set_callback(int fd, const struct select_callback *callback)
       callback = NULL;
     }
 
+#if SELECT_CONF_EPOLL
+    epoll_update(fd, select_callback[fd], callback);
+#endif /* SELECT_CONF_EPOLL */
     select_callback[fd] = callback;
 
     /* Update fd max */
@@ -113,9 +213,14 @@ static void
 stdin_handle_fd(fd_set *rset, fd_set *wset)
 {
   char c;
+  int ret;
   if(FD_ISSET(STDIN_FILENO, rset)) {
-    if(read(STDIN_FILENO, &c, 1) > 0) {
+    ret = read(STDIN_FILENO, &c, 1);
+    if(ret > 0) {
       serial_line_input_byte(c);
+    } else if(ret == 0 || (errno != EINTR && errno != EAGAIN)) {
+      /* end of input or a real error; stop waiting for it */
+      select_set_callback(STDIN_FILENO, NULL);
     }
   }
 }
@@ -155,6 +260,177 @@ set_rime_addr(void)
 int contiki_argc = 0;
 char **contiki_argv;
 
+#if SELECT_CONF_EPOLL
+/*
+ * Call the callbacks of the descriptors that are ready for something
+ * their set_fd() function asks for. Returns the number of them that
+ * are still ready afterwards, e.g. because the callback only read part
+ * of the input.
+ */
+static int
+dispatch_ready(void)
+{
+  struct pollfd pfd[SELECT_MAX];
+  const struct select_callback *cb;
+  fd_set fdr;
+  fd_set fdw;
+  int i, n, fd, still_ready;
+
+  n = 0;
+  for(i = 0; i < ready_count; i++) {
+    fd = ready_list[i];
+    cb = select_callback[fd];
+    FD_ZERO(&fdr);
+    FD_ZERO(&fdw);
+    if(!cb->set_fd(&fdr, &fdw)) {
+      continue;
+    }
+    if(!(ready[fd] & READY_READ)) {
+      FD_CLR(fd, &fdr);
+    }
+    if(!(ready[fd] & READY_WRITE)) {
+      FD_CLR(fd, &fdw);
+    }
+    if(FD_ISSET(fd, &fdr) || FD_ISSET(fd, &fdw)) {
+      pfd[n].fd = fd;
+      pfd[n].events = (FD_ISSET(fd, &fdr) ? POLLIN : 0) |
+        (FD_ISSET(fd, &fdw) ? POLLOUT : 0);
+      n++;
+    }
+  }
+
+  /* The callbacks may register or remove descriptors, so ready_list is
+     not walked while they run. */
+  for(i = 0; i < n; i++) {
+    fd = pfd[i].fd;
+    if(select_callback[fd] == NULL) {
+      pfd[i].fd = -1;
+      continue;
+    }
+    FD_ZERO(&fdr);
+    FD_ZERO(&fdw);
+    if(pfd[i].events & POLLIN) {
+      FD_SET(fd, &fdr);
+    }
+    if(pfd[i].events & POLLOUT) {
+      FD_SET(fd, &fdw);
+    }
+    select_callback[fd]->handle_fd(&fdr, &fdw);
+  }
+
+  if(n == 0 || poll(pfd, n, 0) < 0) {
+    return 0;
+  }
+
+  still_ready = 0;
+  for(i = 0; i < n; i++) {
+    fd = pfd[i].fd;
+    if(fd < 0 || ready[fd] == 0) {
+      continue;
+    }
+    if((pfd[i].events & POLLIN) &&
+       !(pfd[i].revents & (POLLIN | POLLHUP | POLLERR))) {
+      ready[fd] &= ~READY_READ;
+    }
+    if((pfd[i].events & POLLOUT) &&
+       !(pfd[i].revents & (POLLOUT | POLLERR))) {
+      ready[fd] &= ~READY_WRITE;
+    }
+    if(ready[fd] == 0) {
+      clear_ready(fd);
+    } else if(pfd[i].revents != 0) {
+      still_ready++;
+    }
+  }
+  return still_ready;
+}
+/*---------------------------------------------------------------------------*/
+/* The time, in ms, until the next etimer expires. */
+static int
+wait_time(void)
+{
+  clock_time_t now, next;
+  long ticks;
+
+  if(!etimer_pending()) {
+    return SELECT_MAX_WAIT;
+  }
+  next = etimer_next_expiration_time();
+  now = clock_time();
+  ticks = (long)(next - now);
+  if(ticks <= 0) {
+    return 0;
+  }
+  if(ticks >= (long)SELECT_MAX_WAIT * CLOCK_SECOND / 1000) {
+    return SELECT_MAX_WAIT;
+  }
+  return (int)((ticks * 1000 + CLOCK_SECOND - 1) / CLOCK_SECOND);
+}
+/*---------------------------------------------------------------------------*/
+static int
+wait_ready(int timeout)
+{
+  struct epoll_event events[SELECT_MAX];
+  unsigned char bits;
+  int i, n;
+
+  n = epoll_wait(epoll_fd, events, SELECT_MAX, timeout);
+  if(n < 0) {
+    /* signals, e.g. from the rtimer, interrupt the wait */
+    if(errno != EINTR) {
+      perror("epoll_wait");
+    }
+    return 0;
+  }
+  for(i = 0; i < n; i++) {
+    bits = 0;
+    if(events[i].events & (EPOLLIN | EPOLLHUP | EPOLLERR)) {
+      bits |= READY_READ;
+    }
+    if(events[i].events & (EPOLLOUT | EPOLLERR)) {
+      bits |= READY_WRITE;
+    }
+    if(select_callback[events[i].data.fd] != NULL) {
+      set_ready(events[i].data.fd, bits);
+    }
+  }
+  return n;
+}
+#endif /* SELECT_CONF_EPOLL */
+/*---------------------------------------------------------------------------*/
+#if CLOCK_CONF_VIRTUAL
+/* The earliest etimer or rtimer deadline. Returns zero if there is no
+   timer that could ever wake the system up. */
+static int
+next_deadline(clock_time_t *t)
+{
+  clock_time_t rt;
+  int pending;
+
+  pending = etimer_pending();
+  if(pending) {
+    *t = etimer_next_expiration_time();
+  }
+  if(rtimer_arch_next(&rt) && (!pending || (long)(rt - *t) < 0)) {
+    *t = rt;
+    pending = 1;
+  }
+  return pending;
+}
+/*---------------------------------------------------------------------------*/
+/* Called when nothing is left to do at the current time. */
+static void
+advance_time(void)
+{
+  clock_time_t t;
+
+  if(next_deadline(&t)) {
+    clock_jump(t);
+    rtimer_arch_run_due();
+  }
+}
+#endif /* CLOCK_CONF_VIRTUAL */
+/*---------------------------------------------------------------------------*/
 int
 main(int argc, char **argv)
 {
@@ -229,6 +505,31 @@ main(int argc, char **argv)
 
   select_set_callback(STDIN_FILENO, &stdin_fd);
   while(1) {
+#if SELECT_CONF_EPOLL
+    int retval;
+
+    retval = process_run();
+#if CLOCK_CONF_VIRTUAL
+    rtimer_arch_run_due();
+#endif /* CLOCK_CONF_VIRTUAL */
+
+    if(dispatch_ready() > 0 || retval > 0 || process_nevents() > 0) {
+      /* more to do right away; just pick up new edges */
+      wait_ready(0);
+    } else {
+#if CLOCK_CONF_VIRTUAL
+      clock_time_t t;
+
+      /* The clock stands still while waiting, so only block when no
+         timer could ever expire. */
+      if(wait_ready(next_deadline(&t) ? 0 : -1) == 0) {
+        advance_time();
+      }
+#else /* CLOCK_CONF_VIRTUAL */
+      wait_ready(wait_time());
+#endif /* CLOCK_CONF_VIRTUAL */
+    }
+#else /* SELECT_CONF_EPOLL */
     fd_set fdr;
     fd_set fdw;
     int maxfd;
@@ -236,10 +537,29 @@ main(int argc, char **argv)
     int retval;
     struct timeval tv;
 
+    struct timeval *wait;
+#if CLOCK_CONF_VIRTUAL
+    clock_time_t t;
+    int idle;
+#endif /* CLOCK_CONF_VIRTUAL */
+
     retval = process_run();
 
+    wait = &tv;
+#if CLOCK_CONF_VIRTUAL
+    rtimer_arch_run_due();
+    idle = retval == 0 && process_nevents() == 0;
+    tv.tv_sec = 0;
+    tv.tv_usec = 0;
+    /* The clock stands still while waiting, so only block when no
+       timer could ever expire. */
+    if(idle && !next_deadline(&t)) {
+      wait = NULL;
+    }
+#else /* CLOCK_CONF_VIRTUAL */
     tv.tv_sec = 0;
     tv.tv_usec = retval ? 1 : 1000;
+#endif /* CLOCK_CONF_VIRTUAL */
 
     FD_ZERO(&fdr);
     FD_ZERO(&fdw);
@@ -250,7 +570,7 @@ main(int argc, char **argv)
       }
     }
 
-    retval = select(maxfd + 1, &fdr, &fdw, NULL, &tv);
+    retval = select(maxfd + 1, &fdr, &fdw, NULL, wait);
     if(retval < 0) {
       perror("select");
     } else if(retval > 0) {
@@ -261,6 +581,12 @@ main(int argc, char **argv)
         }
       }
     }
+#if CLOCK_CONF_VIRTUAL
+    if(idle && retval == 0) {
+      advance_time();
+    }
+#endif /* CLOCK_CONF_VIRTUAL */
+#endif /* SELECT_CONF_EPOLL */
 
     etimer_request_poll();
   }